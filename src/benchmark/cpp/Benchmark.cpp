@@ -0,0 +1,173 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "Benchmark.hpp"
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/os.h>
+#include <wpi/StringRef.h>
+#include <wpi/json.h>
+
+using namespace frc3512;
+
+namespace {
+
+struct RegisteredBenchmark {
+    std::string name;
+    std::function<void(BenchmarkState&)> func;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations;
+
+    // Time per iteration in nanoseconds
+    double realTime;
+    double cpuTime;
+};
+
+std::vector<RegisteredBenchmark>& GetBenchmarks() {
+    static std::vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+}
+
+// Upper bound on iterations so a benchmark that's optimized away doesn't run
+// forever
+constexpr uint64_t kMaxIterations = 1000000000;
+
+BenchmarkResult RunBenchmark(const RegisteredBenchmark& benchmark,
+                             double minTime) {
+    uint64_t iterations = 1;
+    while (true) {
+        BenchmarkState state{iterations};
+        benchmark.func(state);
+
+        double realTime = state.RealTime();
+        if (realTime >= minTime || iterations >= kMaxIterations) {
+            return {benchmark.name, iterations, realTime / iterations * 1e9,
+                    state.CPUTime() / iterations * 1e9};
+        }
+
+        // Aim 40% past the minimum time, growing by at most 10x per attempt
+        double multiplier = minTime * 1.4 / std::max(realTime, 1e-9);
+        multiplier = std::min(std::max(multiplier, 2.0), 10.0);
+        iterations = std::min(
+            static_cast<uint64_t>(iterations * multiplier), kMaxIterations);
+    }
+}
+
+wpi::json ToJson(const BenchmarkResult& result, int repetition) {
+    return wpi::json{{"name", result.name},
+                     {"run_name", result.name},
+                     {"run_type", "iteration"},
+                     {"repetition_index", repetition},
+                     {"threads", 1},
+                     {"iterations", result.iterations},
+                     {"real_time", result.realTime},
+                     {"cpu_time", result.cpuTime},
+                     {"time_unit", "ns"}};
+}
+
+}  // namespace
+
+BenchmarkState::BenchmarkState(uint64_t iterations)
+    : m_iterations{iterations}, m_remaining{iterations} {}
+
+uint64_t BenchmarkState::Iterations() const { return m_iterations; }
+
+double BenchmarkState::RealTime() const { return m_realTime; }
+
+double BenchmarkState::CPUTime() const { return m_cpuTime; }
+
+void BenchmarkState::Start() {
+    m_cpuStart = std::clock();
+    m_realStart = std::chrono::steady_clock::now();
+}
+
+void BenchmarkState::Stop() {
+    auto realEnd = std::chrono::steady_clock::now();
+    auto cpuEnd = std::clock();
+    m_realTime = std::chrono::duration<double>(realEnd - m_realStart).count();
+    m_cpuTime = static_cast<double>(cpuEnd - m_cpuStart) / CLOCKS_PER_SEC;
+}
+
+void frc3512::RegisterBenchmark(std::string name,
+                                std::function<void(BenchmarkState&)> func) {
+    GetBenchmarks().push_back({std::move(name), std::move(func)});
+}
+
+int frc3512::RunBenchmarks(int argc, char* argv[]) {
+    std::string filter;
+    double minTime = 0.5;
+    int repetitions = 1;
+    std::string outPath;
+
+    for (int i = 1; i < argc; ++i) {
+        wpi::StringRef arg{argv[i]};
+        if (arg.consume_front("--benchmark_filter=")) {
+            filter = arg.str();
+        } else if (arg.consume_front("--benchmark_min_time=")) {
+            minTime = std::stod(arg.str());
+        } else if (arg.consume_front("--benchmark_repetitions=")) {
+            repetitions = std::max(1, std::stoi(arg.str()));
+        } else if (arg.consume_front("--benchmark_out=")) {
+            outPath = arg.str();
+        } else {
+            fmt::print(stderr,
+                       "usage: {} [--benchmark_filter=<substring>] "
+                       "[--benchmark_min_time=<seconds>] "
+                       "[--benchmark_repetitions=<count>] "
+                       "[--benchmark_out=<path>]\n",
+                       argv[0]);
+            return 1;
+        }
+    }
+
+    fmt::print("{:<48} {:>14} {:>14} {:>12}\n", "Benchmark", "Time (ns)",
+               "CPU (ns)", "Iterations");
+    fmt::print("{:-<91}\n", "");
+
+    wpi::json results = wpi::json::array();
+    for (const auto& benchmark : GetBenchmarks()) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        for (int repetition = 0; repetition < repetitions; ++repetition) {
+            auto result = RunBenchmark(benchmark, minTime);
+            fmt::print("{:<48} {:>14.1f} {:>14.1f} {:>12}\n", result.name,
+                       result.realTime, result.cpuTime, result.iterations);
+            results.push_back(ToJson(result, repetition));
+        }
+    }
+
+    if (!outPath.empty()) {
+        wpi::json context{
+            {"executable", argv[0]},
+            {"num_cpus", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+            {"library_build_type", "release"}
+#else
+            {"library_build_type", "debug"}
+#endif
+        };
+
+        // fmt's default flags don't truncate an existing file
+        auto file = fmt::output_file(
+            outPath, fmt::file::WRONLY | fmt::file::CREATE | O_TRUNC);
+        file.print("{}\n",
+                   wpi::json{{"context", context}, {"benchmarks", results}}
+                       .dump(2));
+    }
+
+    return 0;
+}
+
+void frc3512::detail::UseCharPointer(const volatile char*) {}
@@ -0,0 +1,264 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Times the code that runs every robot loop against the simulated HAL.
+//
+// Simulated time is paused, so Notifiers like the shooter controller's don't
+// run in the background and the benchmarks call their update functions
+// directly.
+
+#include <fmt/compile.h>
+#include <frc/AnalogGyro.h>
+#include <frc/Joystick.h>
+#include <frc/Talon.h>
+#include <frc/drive/MecanumDrive.h>
+#include <frc/geometry/Pose2d.h>
+#include <frc/simulation/SimHooks.h>
+#include <hal/HAL.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/length.h>
+
+#include "AutonomousChooser.hpp"
+#include "Benchmark.hpp"
+#include "BusVoltage.hpp"
+#include "Coroutine.hpp"
+#include "GeartoothEncoder.hpp"
+#include "LoopProfiler.hpp"
+#include "Robot.hpp"
+#include "controllers/FlywheelConstants.hpp"
+#include "controllers/FlywheelController.hpp"
+#include "controllers/HolonomicTrajectoryController.hpp"
+#include "controllers/MecanumVelocityController.hpp"
+#include "controllers/PIDFlywheelController.hpp"
+#include "controllers/StateSpaceFlywheelController.hpp"
+#include "subsystems/Feeder.hpp"
+#include "subsystems/Shooter.hpp"
+#include "telemetry/ConsoleLog.hpp"
+#include "telemetry/MpscRing.hpp"
+#include "telemetry/TelemetryLogger.hpp"
+
+using frc3512::BenchmarkState;
+
+namespace {
+
+void BM_FlywheelControllerUpdate(BenchmarkState& state,
+                                 FlywheelController& controller) {
+    controller.Reset(0_rpm);
+    controller.SetReference(3000_rpm);
+
+    while (state.KeepRunning()) {
+        frc3512::DoNotOptimize(controller.Update(2900_rpm));
+    }
+}
+
+void BM_ShooterUpdate(BenchmarkState& state, Shooter::ControllerType type) {
+    frc3512::BusVoltage busVoltage;
+    busVoltage.Update();
+
+    frc3512::TelemetryLogger telemetry;
+    Shooter shooter{busVoltage, telemetry};
+    shooter.SetControllerType(type);
+    shooter.Enable();
+    shooter.SetReference(3000_rpm);
+
+    // Replaces the simulated flywheel so its model isn't stepped and
+    // rediscretized in the timed loop
+    shooter.SetSimulatedMeasurementSource([] { return 2900_rpm; });
+
+    while (state.KeepRunning()) {
+        shooter.Update();
+    }
+}
+
+void BM_FeederUpdate(BenchmarkState& state) {
+    frc3512::TelemetryLogger telemetry;
+    Feeder feeder{telemetry};
+    feeder.Activate();
+
+    while (state.KeepRunning()) {
+        feeder.Update();
+    }
+}
+
+void BM_GeartoothEncoderGetRate(BenchmarkState& state,
+                                GeartoothEncoder::EstimationMode mode) {
+    GeartoothEncoder encoder{9, 56, 4.0, mode};
+
+    while (state.KeepRunning()) {
+        frc3512::DoNotOptimize(encoder.GetRate());
+    }
+}
+
+void BM_ScaleZ(BenchmarkState& state) {
+    frc::Joystick stick{2};
+
+    while (state.KeepRunning()) {
+        frc3512::DoNotOptimize(ScaleZ(stick));
+    }
+}
+
+void BM_DriveCartesian(BenchmarkState& state) {
+    frc::Talon flMotor{3};
+    frc::Talon rlMotor{5};
+    frc::Talon frMotor{7};
+    frc::Talon rrMotor{1};
+    frc::MecanumDrive drive{flMotor, rlMotor, frMotor, rrMotor};
+    frc::AnalogGyro gyro{0};
+
+    while (state.KeepRunning()) {
+        drive.DriveCartesian(0.5, -0.25, 0.1, gyro.GetAngle());
+    }
+}
+
+void BM_MecanumVelocityControllerUpdate(BenchmarkState& state) {
+    MecanumVelocityController controller{20_ms};
+    MecanumVelocityController::WheelVector velocities;
+    velocities << 1.0, -0.5, 0.5, 1.0;
+
+    while (state.KeepRunning()) {
+        frc3512::DoNotOptimize(controller.Update(
+            MecanumVelocityController::CartesianToWheelSpeeds(0.5, -0.25, 0.1,
+                                                              30.0),
+            velocities));
+    }
+}
+
+void BM_HolonomicTrajectoryControllerCalculate(BenchmarkState& state) {
+    HolonomicTrajectoryController controller;
+    frc::Pose2d pose{0.95_m, -0.45_m, 30_deg};
+    frc3512::TrajectorySample reference{1.0f, -0.5f, 0.5f, 0.8f, -0.6f, 1.2f};
+
+    while (state.KeepRunning()) {
+        frc3512::DoNotOptimize(controller.Calculate(pose, reference));
+    }
+}
+
+void BM_CoroutineRoundTrip(BenchmarkState& state) {
+    frc3512::Coroutine coroutine;
+    bool running = true;
+    coroutine.Start([&] {
+        while (running) {
+            frc3512::Coroutine::Yield();
+        }
+    });
+
+    // Each iteration switches to the coroutine's stack and back
+    while (state.KeepRunning()) {
+        coroutine.Resume();
+    }
+
+    running = false;
+    coroutine.Resume();
+}
+
+void BM_AutonomousChooserRoundTrip(
+    BenchmarkState& state,
+    frc3512::AutonomousChooser::ExecutionMode executionMode) {
+    frc3512::AutonomousChooser chooser{"No-op", [] {}};
+    chooser.AddAutonomous("Yield", [&] {
+        while (chooser.AwaitNextCycle()) {
+        }
+    });
+    chooser.SetExecutionMode(executionMode);
+    chooser.SelectAutonomous("Yield");
+    chooser.AwaitStartAutonomous();
+
+    // Each iteration resumes the autonomous mode and waits for it to yield
+    while (state.KeepRunning()) {
+        chooser.AwaitRunAutonomous();
+    }
+
+    chooser.EndAutonomous();
+}
+
+void BM_LoopProfilerProbe(BenchmarkState& state) {
+    frc3512::LoopProfiler profiler{"Benchmark", {"Stage"}, 20_ms};
+
+    while (state.KeepRunning()) {
+        auto probe = profiler.Probe(0);
+    }
+}
+
+void BM_FormatConsoleLine(BenchmarkState& state) {
+    double latency = 1.234;
+
+    while (state.KeepRunning()) {
+        frc3512::DoNotOptimize(frc3512::FormatConsoleLine(
+            frc3512::ConsoleStream::kOut,
+            FMT_COMPILE(
+                "Autonomous mode started {:.3f} ms after AutonomousInit\n"),
+            latency));
+    }
+}
+
+void BM_ConsoleLinePushPop(BenchmarkState& state) {
+    frc3512::MpscRing<frc3512::ConsoleLine, 256> ring;
+    auto line = frc3512::FormatConsoleLine(frc3512::ConsoleStream::kOut,
+                                           FMT_COMPILE("No-op autonomous\n"));
+
+    while (state.KeepRunning()) {
+        ring.Push(line);
+        ring.Pop(line);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    HAL_Initialize(500, 0);
+    frc::sim::PauseTiming();
+
+    frc3512::RegisterBenchmark(
+        "PIDFlywheelController::Update", [](auto& state) {
+            PIDFlywheelController controller{
+                FlywheelConstants{}, Shooter::kDefaultControllerPeriod};
+            BM_FlywheelControllerUpdate(state, controller);
+        });
+    frc3512::RegisterBenchmark(
+        "StateSpaceFlywheelController::Update", [](auto& state) {
+            StateSpaceFlywheelController controller{
+                FlywheelConstants{}, Shooter::kDefaultControllerPeriod};
+            BM_FlywheelControllerUpdate(state, controller);
+        });
+    frc3512::RegisterBenchmark("Shooter::Update/PID", [](auto& state) {
+        BM_ShooterUpdate(state, Shooter::ControllerType::kPID);
+    });
+    frc3512::RegisterBenchmark("Shooter::Update/StateSpace", [](auto& state) {
+        BM_ShooterUpdate(state, Shooter::ControllerType::kStateSpace);
+    });
+    frc3512::RegisterBenchmark("Feeder::Update", BM_FeederUpdate);
+    frc3512::RegisterBenchmark(
+        "GeartoothEncoder::GetRate/CounterPeriod", [](auto& state) {
+            BM_GeartoothEncoderGetRate(
+                state, GeartoothEncoder::EstimationMode::kCounterPeriod);
+        });
+    frc3512::RegisterBenchmark(
+        "GeartoothEncoder::GetRate/EdgeTimestamps", [](auto& state) {
+            BM_GeartoothEncoderGetRate(
+                state, GeartoothEncoder::EstimationMode::kEdgeTimestamps);
+        });
+    frc3512::RegisterBenchmark("ScaleZ", BM_ScaleZ);
+    frc3512::RegisterBenchmark("MecanumDrive::DriveCartesian",
+                               BM_DriveCartesian);
+    frc3512::RegisterBenchmark("MecanumVelocityController::Update",
+                               BM_MecanumVelocityControllerUpdate);
+    frc3512::RegisterBenchmark("HolonomicTrajectoryController::Calculate",
+                               BM_HolonomicTrajectoryControllerCalculate);
+    frc3512::RegisterBenchmark("Coroutine::Resume", BM_CoroutineRoundTrip);
+    frc3512::RegisterBenchmark(
+        "AutonomousChooser::AwaitRunAutonomous/Coroutine", [](auto& state) {
+            BM_AutonomousChooserRoundTrip(
+                state, frc3512::AutonomousChooser::ExecutionMode::kCoroutine);
+        });
+    frc3512::RegisterBenchmark(
+        "AutonomousChooser::AwaitRunAutonomous/Thread", [](auto& state) {
+            BM_AutonomousChooserRoundTrip(
+                state, frc3512::AutonomousChooser::ExecutionMode::kThread);
+        });
+    frc3512::RegisterBenchmark("LoopProfiler::Probe", BM_LoopProfilerProbe);
+    frc3512::RegisterBenchmark("FormatConsoleLine", BM_FormatConsoleLine);
+    frc3512::RegisterBenchmark("ConsoleLine MpscRing::Push/Pop",
+                               BM_ConsoleLinePushPop);
+
+    return frc3512::RunBenchmarks(argc, argv);
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+
+namespace frc3512 {
+
+/**
+ * Controls the timed loop of a benchmark.
+ *
+ * A benchmark does its setup, then calls KeepRunning() until it returns false.
+ * Only the time spent in that loop is measured.
+ *
+ * @code{.cpp}
+ * void BM_Example(frc3512::BenchmarkState& state) {
+ *     Example example;
+ *     while (state.KeepRunning()) {
+ *         frc3512::DoNotOptimize(example.Compute());
+ *     }
+ * }
+ * @endcode
+ */
+class BenchmarkState {
+public:
+    /**
+     * Constructs a BenchmarkState.
+     *
+     * @param iterations Number of times KeepRunning() returns true.
+     */
+    explicit BenchmarkState(uint64_t iterations);
+
+    /**
+     * Returns true if the benchmark should run another iteration.
+     *
+     * The timer starts on the first call and stops on the call that returns
+     * false.
+     */
+    bool KeepRunning() {
+        if (m_remaining == m_iterations) {
+            Start();
+        }
+        if (m_remaining == 0) {
+            Stop();
+            return false;
+        }
+        --m_remaining;
+        return true;
+    }
+
+    /**
+     * Returns the number of iterations the benchmark runs.
+     */
+    uint64_t Iterations() const;
+
+    /**
+     * Returns the wall clock time of the timed loop in seconds.
+     */
+    double RealTime() const;
+
+    /**
+     * Returns the process CPU time of the timed loop in seconds.
+     */
+    double CPUTime() const;
+
+private:
+    uint64_t m_iterations;
+    uint64_t m_remaining;
+
+    std::chrono::steady_clock::time_point m_realStart;
+    std::clock_t m_cpuStart = 0;
+    double m_realTime = 0.0;
+    double m_cpuTime = 0.0;
+
+    void Start();
+    void Stop();
+};
+
+/**
+ * Adds a benchmark to the set run by RunBenchmarks().
+ *
+ * @param name Name of the benchmark.
+ * @param func Benchmark function.
+ */
+void RegisterBenchmark(std::string name,
+                       std::function<void(BenchmarkState&)> func);
+
+/**
+ * Runs the registered benchmarks and reports the time per iteration.
+ *
+ * Each benchmark's iteration count grows until its timed loop takes at least
+ * the minimum time. Results are printed as a table, and optionally written to
+ * a file in Google Benchmark's JSON format so they can be compared between
+ * commits with its tools/compare.py.
+ *
+ * Supported arguments:
+ * - --benchmark_filter=<substring>: only runs benchmarks whose name contains
+ *   the substring
+ * - --benchmark_min_time=<seconds>: minimum time of each timed loop
+ *   (default 0.5)
+ * - --benchmark_repetitions=<count>: number of times each benchmark is run
+ *   (default 1)
+ * - --benchmark_out=<path>: writes the JSON results to the file
+ *
+ * @return The process exit code.
+ */
+int RunBenchmarks(int argc, char* argv[]);
+
+namespace detail {
+void UseCharPointer(const volatile char* pointer);
+}  // namespace detail
+
+/**
+ * Prevents the compiler from optimizing away the computation of a value.
+ *
+ * @param value Value that must be computed.
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#ifdef _MSC_VER
+    detail::UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "m"(value) : "memory");
+#endif
+}
+
+}  // namespace frc3512
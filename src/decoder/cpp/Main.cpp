@@ -0,0 +1,99 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Decodes a telemetry log recorded by the robot into CSV or columnar files.
+//
+// Usage: telemetryDecoder <log> [--format csv|columnar] [--output <dir>]
+//                         [--threads N]
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fmt/core.h>
+#include <fmt/os.h>
+
+#include "MappedFile.hpp"
+#include "TelemetryDecoder.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string logPath;
+    std::string outputDir = ".";
+    auto format = TelemetryOutputFormat::kCsv;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            std::string value = argv[++i];
+            if (value == "csv") {
+                format = TelemetryOutputFormat::kCsv;
+            } else if (value == "columnar") {
+                format = TelemetryOutputFormat::kColumnar;
+            } else {
+                fmt::print(stderr, "error: unknown format {}\n", value);
+                return 1;
+            }
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max(1, std::atoi(argv[++i]));
+        } else if (logPath.empty() && arg.rfind("--", 0) != 0) {
+            logPath = arg;
+        } else {
+            logPath.clear();
+            break;
+        }
+    }
+
+    if (logPath.empty()) {
+        fmt::print(stderr,
+                   "usage: {} <log> [--format csv|columnar] [--output <dir>] "
+                   "[--threads N]\n",
+                   argv[0]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        MappedFile file{logPath};
+        TelemetryDecoder decoder{file.Data(), file.Size()};
+        auto outputs = decoder.Decode(format, threads);
+
+        for (const auto& [name, contents] : outputs) {
+            // fmt's default flags don't truncate an existing file
+            auto output = fmt::output_file(
+                outputDir + "/" + name,
+                fmt::file::WRONLY | fmt::file::CREATE | O_TRUNC);
+            output.print("{}", fmt::string_view{contents});
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        fmt::print("Decoded {} records ({:.1f} MB) into {} files on {} "
+                   "threads in {:.3f} s\n",
+                   decoder.GetRecordCount(), file.Size() / 1e6,
+                   outputs.size(), threads, seconds);
+        if (decoder.GetSkippedCount() > 0) {
+            fmt::print("Skipped {} records of unknown types\n",
+                       decoder.GetSkippedCount());
+        }
+        if (decoder.GetTruncatedSize() > 0) {
+            fmt::print("Ignored {} bytes of a partial record at the end\n",
+                       decoder.GetTruncatedSize());
+        }
+    } catch (const std::system_error& e) {
+        fmt::print(stderr, "error: {}\n", e.what());
+        return 1;
+    } catch (const std::runtime_error& e) {
+        fmt::print(stderr, "error: {}: {}\n", logPath, e.what());
+        return 1;
+    }
+}
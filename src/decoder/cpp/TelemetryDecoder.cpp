@@ -0,0 +1,354 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "TelemetryDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include "telemetry/TelemetryRecords.hpp"
+
+using namespace frc3512;
+
+namespace {
+
+constexpr size_t kNumRecordTypes = std::tuple_size_v<TelemetryRecordTypes>;
+
+// Offset and size of the drive encoder rates that version 2 added to
+// InputRecord. Version 1 had the same fields before and after them.
+constexpr size_t kInputRatesOffset = offsetof(InputRecord, flRate);
+constexpr size_t kInputRatesSize =
+    offsetof(InputRecord, gyroAngle) - kInputRatesOffset;
+constexpr size_t kInputRecordV1Size = sizeof(InputRecord) - kInputRatesSize;
+
+template <size_t I>
+using RecordType = std::tuple_element_t<I, TelemetryRecordTypes>;
+
+template <typename Func, size_t... I>
+void ForEachRecordTypeImpl(Func&& func, std::index_sequence<I...>) {
+    (func(std::integral_constant<size_t, I>{}), ...);
+}
+
+/**
+ * Calls func with a std::integral_constant of each record type's index in
+ * TelemetryRecordTypes.
+ */
+template <typename Func>
+void ForEachRecordType(Func&& func) {
+    ForEachRecordTypeImpl(func, std::make_index_sequence<kNumRecordTypes>{});
+}
+
+/**
+ * Calls func with each field of a record type's schema.
+ */
+template <typename Record, typename Func>
+void ForEachField(Func&& func) {
+    std::apply([&](const auto&... field) { (func(field), ...); },
+               TelemetrySchema<Record>::kFields);
+}
+
+/**
+ * Returns the integer or floating point type a field is stored as.
+ */
+template <typename T>
+struct StorageType {
+    using type = T;
+};
+
+template <typename T>
+struct StorageTypeOfEnum {
+    using type = std::underlying_type_t<T>;
+};
+
+template <typename T>
+using StorageTypeT = typename std::conditional_t<std::is_enum_v<T>,
+                                                 StorageTypeOfEnum<T>,
+                                                 StorageType<T>>::type;
+
+template <typename T>
+constexpr const char* ColumnTypeName() {
+    using U = StorageTypeT<T>;
+    if constexpr (std::is_same_v<U, uint8_t>) {
+        return "u8";
+    } else if constexpr (std::is_same_v<U, uint16_t>) {
+        return "u16";
+    } else if constexpr (std::is_same_v<U, uint32_t>) {
+        return "u32";
+    } else if constexpr (std::is_same_v<U, int32_t>) {
+        return "i32";
+    } else if constexpr (std::is_same_v<U, uint64_t>) {
+        return "u64";
+    } else if constexpr (std::is_same_v<U, float>) {
+        return "f32";
+    } else {
+        static_assert(std::is_same_v<U, double>,
+                      "Unsupported telemetry field type");
+        return "f64";
+    }
+}
+
+template <typename T>
+void AppendText(fmt::memory_buffer& buffer, T value) {
+    using U = StorageTypeT<T>;
+    if constexpr (std::is_same_v<U, uint8_t>) {
+        // Otherwise it could be formatted as a character
+        fmt::format_to(buffer, "{}", static_cast<unsigned int>(value));
+    } else {
+        // Floats take fmt's shortest round-trip path
+        fmt::format_to(buffer, "{}", static_cast<U>(value));
+    }
+}
+
+template <typename T>
+void AppendBinary(fmt::memory_buffer& buffer, T value) {
+    auto storage = static_cast<StorageTypeT<T>>(value);
+    auto bytes = reinterpret_cast<const char*>(&storage);
+    buffer.append(bytes, bytes + sizeof(storage));
+}
+
+/**
+ * Output files and which of them each record type writes to.
+ */
+struct OutputLayout {
+    std::vector<std::string> names;
+
+    // Contents each file starts with
+    std::vector<std::string> headers;
+
+    // Index of each record type's first file
+    std::array<size_t, kNumRecordTypes> firstFile;
+};
+
+OutputLayout MakeLayout(TelemetryOutputFormat format) {
+    OutputLayout layout;
+
+    auto addType = [&](auto index) {
+        using Record = RecordType<decltype(index)::value>;
+        const char* name = TelemetrySchema<Record>::kName;
+        layout.firstFile[index] = layout.names.size();
+
+        if (format == TelemetryOutputFormat::kCsv) {
+            std::string header = "timestamp_us";
+            ForEachField<Record>([&](const auto& field) {
+                header += ',';
+                header += field.name;
+            });
+            header += '\n';
+
+            layout.names.emplace_back(fmt::format("{}.csv", name));
+            layout.headers.emplace_back(std::move(header));
+        } else {
+            layout.names.emplace_back(
+                fmt::format("{}.timestamp_us.u64", name));
+            layout.headers.emplace_back();
+            ForEachField<Record>([&](const auto& field) {
+                using T = typename std::decay_t<decltype(field)>::Type;
+                layout.names.emplace_back(fmt::format(
+                    "{}.{}.{}", name, field.name, ColumnTypeName<T>()));
+                layout.headers.emplace_back();
+            });
+        }
+    };
+    ForEachRecordType(addType);
+
+    return layout;
+}
+
+}  // namespace
+
+TelemetryDecoder::TelemetryDecoder(const uint8_t* data, size_t size)
+    : m_data{data} {
+    TelemetryLogHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error{"not a telemetry log"};
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != TelemetryLogHeader::kMagic) {
+        throw std::runtime_error{"not a telemetry log"};
+    }
+    if ((header.version != 1 &&
+         header.version != TelemetryLogHeader::kVersion) ||
+        header.recordHeaderSize != sizeof(TelemetryRecordHeader)) {
+        throw std::runtime_error{
+            fmt::format("unsupported log version {}", header.version)};
+    }
+    m_version = header.version;
+
+    // Most records are the smallest size, so this rarely reallocates
+    m_records.reserve(size / (sizeof(TelemetryRecordHeader) + 16));
+
+    size_t offset = sizeof(header);
+    while (size - offset >= sizeof(TelemetryRecordHeader)) {
+        TelemetryRecordHeader recordHeader;
+        std::memcpy(&recordHeader, data + offset, sizeof(recordHeader));
+
+        size_t payload = offset + sizeof(recordHeader);
+        if (size - payload < recordHeader.size) {
+            break;
+        }
+
+        bool known = false;
+        ForEachRecordType([&](auto index) {
+            using Record = RecordType<decltype(index)::value>;
+            if (Record::kType != recordHeader.type) {
+                return;
+            }
+
+            size_t expectedSize = sizeof(Record);
+            if constexpr (std::is_same_v<Record, InputRecord>) {
+                if (m_version == 1) {
+                    expectedSize = kInputRecordV1Size;
+                }
+            }
+            if (recordHeader.size != expectedSize) {
+                throw std::runtime_error{fmt::format(
+                    "{} record at offset {} is {} bytes instead of {}; the "
+                    "log is from a different build",
+                    TelemetrySchema<Record>::kName, offset, recordHeader.size,
+                    expectedSize)};
+            }
+            m_records.push_back({payload, index, recordHeader.timestamp});
+            known = true;
+        });
+        if (!known) {
+            ++m_skipped;
+        }
+
+        offset = payload + recordHeader.size;
+    }
+
+    m_truncated = size - offset;
+}
+
+size_t TelemetryDecoder::GetRecordCount() const { return m_records.size(); }
+
+size_t TelemetryDecoder::GetSkippedCount() const { return m_skipped; }
+
+size_t TelemetryDecoder::GetTruncatedSize() const { return m_truncated; }
+
+InputRecord TelemetryDecoder::ReadInputRecordV1(size_t offset) const {
+    InputRecord record;
+    auto bytes = reinterpret_cast<uint8_t*>(&record);
+    std::memcpy(bytes, m_data + offset, kInputRatesOffset);
+    std::memcpy(bytes + kInputRatesOffset + kInputRatesSize,
+                m_data + offset + kInputRatesOffset,
+                kInputRecordV1Size - kInputRatesOffset);
+
+    // The rates weren't logged
+    record.flRate = std::numeric_limits<float>::quiet_NaN();
+    record.rlRate = std::numeric_limits<float>::quiet_NaN();
+    record.frRate = std::numeric_limits<float>::quiet_NaN();
+    record.rrRate = std::numeric_limits<float>::quiet_NaN();
+
+    return record;
+}
+
+std::map<std::string, std::string> TelemetryDecoder::Decode(
+    TelemetryOutputFormat format, unsigned int threads) const {
+    auto layout = MakeLayout(format);
+
+    // Decodes records [first, last) into one buffer per output file
+    auto decodeChunk = [&](size_t first, size_t last,
+                           std::vector<fmt::memory_buffer>& buffers) {
+        for (size_t i = first; i < last; ++i) {
+            const auto& ref = m_records[i];
+            ForEachRecordType([&](auto index) {
+                if (index != ref.typeIndex) {
+                    return;
+                }
+
+                using Record = RecordType<decltype(index)::value>;
+                auto record = ReadRecord<Record>(ref.offset);
+
+                size_t file = layout.firstFile[index];
+                if (format == TelemetryOutputFormat::kCsv) {
+                    auto& buffer = buffers[file];
+                    fmt::format_to(buffer, "{}", ref.timestamp);
+                    ForEachField<Record>([&](const auto& field) {
+                        buffer.push_back(',');
+                        AppendText(buffer, record.*field.member);
+                    });
+                    buffer.push_back('\n');
+                } else {
+                    AppendBinary(buffers[file], ref.timestamp);
+                    ForEachField<Record>([&](const auto& field) {
+                        AppendBinary(buffers[++file], record.*field.member);
+                    });
+                }
+            });
+        }
+    };
+
+    size_t chunkCount = std::clamp<size_t>(threads, 1, m_records.size());
+    if (m_records.empty()) {
+        chunkCount = 0;
+    }
+
+    std::vector<std::vector<fmt::memory_buffer>> chunks(chunkCount);
+    std::vector<std::thread> workers;
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        chunks[chunk].resize(layout.names.size());
+        size_t first = m_records.size() * chunk / chunkCount;
+        size_t last = m_records.size() * (chunk + 1) / chunkCount;
+        workers.emplace_back([&, chunk, first, last] {
+            decodeChunk(first, last, chunks[chunk]);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Join the chunks in order
+    std::map<std::string, std::string> files;
+    for (size_t file = 0; file < layout.names.size(); ++file) {
+        std::string contents = std::move(layout.headers[file]);
+
+        size_t size = contents.size();
+        for (const auto& buffers : chunks) {
+            size += buffers[file].size();
+        }
+        contents.reserve(size);
+
+        for (const auto& buffers : chunks) {
+            contents.append(buffers[file].data(), buffers[file].size());
+        }
+        files.emplace(layout.names[file], std::move(contents));
+    }
+
+    if (format == TelemetryOutputFormat::kColumnar) {
+        // Describes the column files in the same order as the CSV columns
+        fmt::memory_buffer schema;
+        fmt::format_to(schema, "{{\n");
+        ForEachRecordType([&](auto index) {
+            using Record = RecordType<decltype(index)::value>;
+            const char* name = TelemetrySchema<Record>::kName;
+
+            fmt::format_to(schema, "{}  \"{}\": [\n",
+                           index == 0 ? "" : ",\n", name);
+            fmt::format_to(schema,
+                           "    {{\"name\": \"timestamp_us\", \"type\": "
+                           "\"u64\"}}");
+            ForEachField<Record>([&](const auto& field) {
+                using T = typename std::decay_t<decltype(field)>::Type;
+                fmt::format_to(schema,
+                               ",\n    {{\"name\": \"{}\", \"type\": "
+                               "\"{}\"}}",
+                               field.name, ColumnTypeName<T>());
+            });
+            fmt::format_to(schema, "\n  ]");
+        });
+        fmt::format_to(schema, "\n}}\n");
+        files.emplace("schema.json", fmt::to_string(schema));
+    }
+
+    return files;
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "telemetry/TelemetryRecords.hpp"
+
+/**
+ * Output formats of TelemetryDecoder.
+ */
+enum class TelemetryOutputFormat {
+    /// One CSV file per record type with a header row
+    kCsv,
+    /// One raw little-endian array per column, named
+    /// "<record>.<column>.<type>", plus a schema.json describing them
+    kColumnar
+};
+
+/**
+ * Decodes a telemetry log written by frc3512::TelemetryLogger.
+ *
+ * The output columns are generated from the TelemetrySchema of each record
+ * type in TelemetryRecords.hpp, the same definitions the robot logs with. Every
+ * record type's first column is its FPGA timestamp in microseconds.
+ *
+ * Records are indexed in one sequential pass over their headers, then the
+ * index is split into chunks that are decoded on separate threads and joined
+ * in order.
+ */
+class TelemetryDecoder {
+public:
+    /**
+     * Validates a log's header and indexes its records.
+     *
+     * A partial record at the end, as left by a power loss, is ignored. So are
+     * records of unknown types, since their size is in their header.
+     *
+     * Version 1 logs are also accepted. Their InputRecords didn't have the
+     * drive encoder rates, so those decode as NaN.
+     *
+     * @param data Contents of the log. It must outlive the decoder.
+     * @param size Size of the log in bytes.
+     * @throws std::runtime_error if the data isn't a log this build can
+     *         decode.
+     */
+    TelemetryDecoder(const uint8_t* data, size_t size);
+
+    /**
+     * Returns the number of records that will be decoded.
+     */
+    size_t GetRecordCount() const;
+
+    /**
+     * Returns the number of records skipped because their type is unknown.
+     */
+    size_t GetSkippedCount() const;
+
+    /**
+     * Returns the number of bytes at the end of the log that don't form a
+     * whole record.
+     */
+    size_t GetTruncatedSize() const;
+
+    /**
+     * Decodes the log.
+     *
+     * @param format  Output format.
+     * @param threads Number of threads to decode on.
+     * @return Map of output file names to their contents.
+     */
+    std::map<std::string, std::string> Decode(TelemetryOutputFormat format,
+                                              unsigned int threads) const;
+
+    /**
+     * Returns every record of one type in the order they were logged.
+     */
+    template <typename Record>
+    std::vector<frc3512::TimestampedRecord<Record>> GetRecords() const {
+        std::vector<frc3512::TimestampedRecord<Record>> records;
+        for (const auto& ref : m_records) {
+            frc3512::TelemetryRecordHeader header;
+            std::memcpy(&header, m_data + ref.offset - sizeof(header),
+                        sizeof(header));
+            if (header.type == Record::kType) {
+                auto& entry = records.emplace_back();
+                entry.timestamp = ref.timestamp;
+                entry.record = ReadRecord<Record>(ref.offset);
+            }
+        }
+        return records;
+    }
+
+private:
+    struct RecordRef {
+        // Offset of the record's payload in the log
+        size_t offset;
+
+        // Index of the record type in TelemetryRecordTypes
+        size_t typeIndex;
+
+        uint64_t timestamp;
+    };
+
+    /**
+     * Reads the payload of a record in the log's version of its layout.
+     */
+    template <typename Record>
+    Record ReadRecord(size_t offset) const {
+        if constexpr (std::is_same_v<Record, frc3512::InputRecord>) {
+            if (m_version == 1) {
+                return ReadInputRecordV1(offset);
+            }
+        }
+
+        Record record;
+        std::memcpy(&record, m_data + offset, sizeof(record));
+        return record;
+    }
+
+    /**
+     * Reads a version 1 InputRecord, which didn't have the drive encoder
+     * rates, into the current layout.
+     */
+    frc3512::InputRecord ReadInputRecordV1(size_t offset) const;
+
+    const uint8_t* m_data;
+    uint32_t m_version;
+    std::vector<RecordRef> m_records;
+    size_t m_skipped = 0;
+    size_t m_truncated = 0;
+};
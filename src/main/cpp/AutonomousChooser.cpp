@@ -3,115 +3,379 @@
 #include "AutonomousChooser.hpp"
 
 #include <algorithm>
+#include <exception>
+#include <stdexcept>
 
-#include <fmt/core.h>
+#include <fmt/compile.h>
 #include <frc/smartdashboard/SmartDashboard.h>
+#include <units/time.h>
+#include <wpi/SmallVector.h>
+
+#include "RealTime.hpp"
+#include "telemetry/ConsoleLog.hpp"
 
 namespace frc3512 {
 
 AutonomousChooser::AutonomousChooser(wpi::StringRef name,
                                      std::function<void()> func) {
     m_defaultChoice = name;
-    m_choices[name] = func;
-    m_names.emplace_back(name);
-
-    m_selectedChoice = name;
-    m_selectedAuton = &m_choices[name];
+    AddAutonomous(name, func);
 
     frc::SmartDashboard::PutData("Autonomous modes", this);
 
+    // Local updates come from SelectAutonomous(), which already resolved the
+    // name, so only the dashboard's selections are resolved here
     m_selectedListenerHandle = m_selectedEntry.AddListener(
         [=](const nt::EntryNotification& event) {
             if (!event.value->IsString()) {
                 return;
             }
 
-            {
-                std::scoped_lock lock{m_mutex};
-                m_selectedChoice = event.value->GetString();
+            // Unknown names are ignored, so the dashboard keeps showing the
+            // last valid selection as active
+            auto name = event.value->GetString();
+            if (SetSelectedIndex(name)) {
+                m_activeEntry.SetString(name);
             }
-
-            m_activeEntry.SetString(m_selectedChoice);
         },
-        NT_NOTIFY_IMMEDIATE | NT_NOTIFY_NEW | NT_NOTIFY_UPDATE |
-            NT_NOTIFY_LOCAL);
+        NT_NOTIFY_IMMEDIATE | NT_NOTIFY_NEW | NT_NOTIFY_UPDATE);
 }
 
 AutonomousChooser::~AutonomousChooser() {
     EndAutonomous();
+    StopWorker();
     m_selectedEntry.RemoveListener(m_selectedListenerHandle);
 }
 
 void AutonomousChooser::AddAutonomous(wpi::StringRef name,
                                       std::function<void()> func) {
-    m_choices[name] = func;
+    {
+        std::scoped_lock lock{m_mutex};
+
+        auto index = m_choiceIndices.find(name);
+        if (index != m_choiceIndices.end()) {
+            m_choices[index->second] = func;
+            return;
+        }
+
+        m_choiceIndices[name] = m_choices.size();
+        m_choices.emplace_back(func);
+        m_choiceNames.emplace_back(name);
+    }
+
     m_names.emplace_back(name);
 
-    // Unlike std::map, wpi::StringMap elements are not sorted
+    // Keep the dashboard's list in alphabetical order
     std::sort(m_names.begin(), m_names.end());
 
     m_optionsEntry.SetStringArray(m_names);
 }
 
 void AutonomousChooser::SelectAutonomous(wpi::StringRef name) {
+    if (SetSelectedIndex(name)) {
+        m_selectedEntry.SetString(name);
+        m_activeEntry.SetString(name);
+    }
+}
+
+void AutonomousChooser::SelectAutonomous(size_t index) {
+    std::string name;
     {
         std::scoped_lock lock{m_mutex};
-        m_selectedChoice = name;
+
+        if (index >= m_choiceNames.size()) {
+            LogError(FMT_COMPILE("Unknown autonomous mode {} ignored\n"),
+                     index);
+            return;
+        }
+        name = m_choiceNames[index];
     }
-    m_selectedEntry.SetString(name);
+
+    SelectAutonomous(name);
 }
 
 const std::vector<std::string>& AutonomousChooser::GetAutonomousNames() const {
     return m_names;
 }
 
+void AutonomousChooser::SetExecutionMode(ExecutionMode mode) {
+    m_executionMode = mode;
+
+    if (mode == ExecutionMode::kThread) {
+        StartWorker();
+    } else {
+        StopWorker();
+    }
+}
+
+AutonomousChooser::ExecutionMode AutonomousChooser::GetExecutionMode() const {
+    return m_executionMode;
+}
+
+void AutonomousChooser::SetTelemetry(TelemetryLogger& telemetry) {
+    m_telemetry = &telemetry.AddChannel<AutonomousRecord>();
+}
+
 void AutonomousChooser::YieldToMain() {
+    // This is either the autonomous coroutine itself or a function started by
+    // AwaitAll(). Either way, yielding returns to whoever resumed it.
+    if (Coroutine::Current() != nullptr) {
+        Coroutine::Yield();
+        return;
+    }
+
     m_awaitingAuton = false;
     m_cond.notify_one();
     m_cond.wait(m_autonLock, [&] { return m_awaitingAuton; });
 }
 
+bool AutonomousChooser::AwaitNextCycle() {
+    YieldToMain();
+    return !m_cancelled;
+}
+
+bool AutonomousChooser::AwaitAll(
+    std::initializer_list<std::function<void()>> funcs) {
+    wpi::SmallVector<Coroutine*, kCoroutinePoolSize> coroutines;
+    for (auto& func : funcs) {
+        Coroutine* coroutine = m_coroutinePool.Acquire();
+        if (coroutine == nullptr) {
+            for (auto acquired : coroutines) {
+                m_coroutinePool.Release(acquired);
+            }
+            throw std::runtime_error{
+                "AutonomousChooser::AwaitAll(): coroutine pool exhausted"};
+        }
+
+        coroutine->Start(func);
+        coroutines.emplace_back(coroutine);
+    }
+
+    std::exception_ptr exception;
+    while (true) {
+        bool allDone = true;
+        for (auto coroutine : coroutines) {
+            try {
+                coroutine->Resume();
+            } catch (...) {
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            allDone = allDone && coroutine->IsDone();
+        }
+
+        if (allDone) {
+            break;
+        }
+
+        YieldToMain();
+    }
+
+    for (auto coroutine : coroutines) {
+        m_coroutinePool.Release(coroutine);
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+
+    return !m_cancelled;
+}
+
+bool AutonomousChooser::AwaitFor(units::second_t duration) {
+    frc2::Timer timer;
+    timer.Start();
+    return AwaitUntil([&] { return timer.Get() >= duration; });
+}
+
 void AutonomousChooser::Return() {
+    // A coroutine returns to the main robot thread when its function returns
+    if (m_executionMode == ExecutionMode::kCoroutine) {
+        return;
+    }
+
     m_awaitingAuton = false;
     m_cond.notify_one();
 }
 
-void AutonomousChooser::AwaitStartAutonomous() {
-    {
-        std::scoped_lock lock{m_mutex};
-        fmt::print("{} autonomous\n", m_selectedChoice);
-        m_selectedAuton = &m_choices[m_selectedChoice];
-    }
+void AutonomousChooser::AwaitStartAutonomous(units::second_t initTimestamp) {
+    // The selection was resolved to an index when it arrived, so this is a
+    // single atomic load
+    size_t index = m_selectedIndex.load(std::memory_order_acquire);
+    m_selectedAuton = &m_choices[index];
+    Log(FMT_COMPILE("{} autonomous\n"), m_choiceNames[index]);
 
-    m_awaitingAuton = true;
-    m_autonThread = std::thread{[=] {
-        m_autonLock.lock();
+    // Finish the previous run if it hasn't been already
+    EndAutonomous();
+    m_cancelled = false;
+    m_initTimestamp = initTimestamp;
+
+    if (m_executionMode == ExecutionMode::kCoroutine) {
+        m_autonCoroutine = m_coroutinePool.Acquire();
+        if (m_autonCoroutine == nullptr) {
+            throw std::runtime_error{
+                "AutonomousChooser::AwaitStartAutonomous(): coroutine pool "
+                "exhausted"};
+        }
+        m_autonCoroutine->Start([=] { RunSelectedAuton(); });
         m_autonRunning = true;
-        (*m_selectedAuton)();
-        m_autonRunning = false;
-        Return();
-        m_autonLock.unlock();
-    }};
-    m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
-}
+        ResumeAutonCoroutine();
+    } else {
+        StartWorker();
 
-void AutonomousChooser::AwaitRunAutonomous() {
-    if (m_autonRunning) {
         m_awaitingAuton = true;
         m_cond.notify_one();
         m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
     }
+
+    if (m_telemetry != nullptr) {
+        AutonomousRecord record;
+        record.modeIndex = static_cast<uint32_t>(index);
+        record.startLatency = m_startLatency.to<float>();
+        record.event = AutonomousRecord::kStarted;
+        record.finished = false;
+        m_telemetry->Log(record);
+        m_loggedIndex = static_cast<int>(index);
+    }
+
+    Log(FMT_COMPILE(
+            "Autonomous mode started {:.3f} ms after AutonomousInit\n"),
+        units::millisecond_t{m_startLatency}.to<double>());
 }
 
-void AutonomousChooser::EndAutonomous() {
+void AutonomousChooser::AwaitRunAutonomous() {
+    if (m_executionMode == ExecutionMode::kCoroutine) {
+        if (m_autonRunning) {
+            ResumeAutonCoroutine();
+        }
+        return;
+    }
+
     if (m_autonRunning) {
         m_awaitingAuton = true;
         m_cond.notify_one();
         m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
     }
+}
+
+void AutonomousChooser::EndAutonomous() {
+    m_cancelled = true;
+    bool finished = !m_autonRunning;
+
+    if (m_executionMode == ExecutionMode::kCoroutine) {
+        // Like the join in thread mode, this waits for the autonomous mode
+        // function to return
+        while (m_autonRunning) {
+            ResumeAutonCoroutine();
+        }
+    } else {
+        while (m_autonRunning) {
+            m_awaitingAuton = true;
+            m_cond.notify_one();
+            m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
+        }
+    }
+
+    if (m_telemetry != nullptr && m_loggedIndex >= 0) {
+        AutonomousRecord record;
+        record.modeIndex = static_cast<uint32_t>(m_loggedIndex);
+        record.startLatency = m_startLatency.to<float>();
+        record.event = AutonomousRecord::kEnded;
+        record.finished = finished;
+        m_telemetry->Log(record);
+        m_loggedIndex = -1;
+    }
+}
+
+units::second_t AutonomousChooser::GetStartLatency() const {
+    return m_startLatency;
+}
+
+void AutonomousChooser::ResumeAutonCoroutine() {
+    auto release = [&] {
+        m_coroutinePool.Release(m_autonCoroutine);
+        m_autonCoroutine = nullptr;
+        m_autonRunning = false;
+    };
+
+    try {
+        m_autonCoroutine->Resume();
+    } catch (...) {
+        release();
+        throw;
+    }
+
+    if (m_autonCoroutine->IsDone()) {
+        release();
+    }
+}
+
+void AutonomousChooser::StartWorker() {
     if (m_autonThread.joinable()) {
-        m_autonThread.join();
+        return;
+    }
+
+    m_autonThread = std::thread{[=] {
+        PrefaultStack(kWorkerStackPrefaultSize);
+
+        // Parks here until the main robot thread waits on m_cond
+        m_autonLock.lock();
+        while (true) {
+            m_cond.wait(m_autonLock,
+                        [&] { return m_awaitingAuton || m_stopWorker; });
+            if (m_stopWorker) {
+                break;
+            }
+
+            m_autonRunning = true;
+            RunSelectedAuton();
+            m_autonRunning = false;
+            Return();
+        }
+        m_autonLock.unlock();
+    }};
+
+    // The main robot thread and worker never run at the same time, so the
+    // worker starts on the main robot thread's CPU to keep the handoff's
+    // wakeup local and the caches warm. Only the worker is pinned. Pinning the
+    // main robot thread to one core of the dual-core roboRIO would make it
+    // compete for that core with the Notifier and interrupt threads. If the
+    // scheduler moves the main robot thread later, the handoff becomes a
+    // cross-CPU wakeup, which shows up in the start latency report.
+    PinThreadToCpu(m_autonThread, GetCurrentCpu());
+}
+
+void AutonomousChooser::StopWorker() {
+    if (!m_autonThread.joinable()) {
+        return;
     }
+
+    m_stopWorker = true;
+    m_cond.notify_one();
+    m_mainLock.unlock();
+    m_autonThread.join();
+    m_mainLock.lock();
+    m_stopWorker = false;
+}
+
+bool AutonomousChooser::SetSelectedIndex(wpi::StringRef name) {
+    std::scoped_lock lock{m_mutex};
+
+    auto index = m_choiceIndices.find(name);
+    if (index == m_choiceIndices.end()) {
+        LogError(FMT_COMPILE("Unknown autonomous mode '{}' ignored\n"),
+                 fmt::string_view{name.data(), name.size()});
+        return false;
+    }
+
+    m_selectedIndex.store(index->second, std::memory_order_release);
+    return true;
+}
+
+void AutonomousChooser::RunSelectedAuton() {
+    m_startLatency = frc2::Timer::GetFPGATimestamp() - m_initTimestamp;
+    (*m_selectedAuton)();
 }
 
 void AutonomousChooser::InitSendable(frc::SendableBuilder& builder) {
@@ -127,6 +391,11 @@ void AutonomousChooser::InitSendable(frc::SendableBuilder& builder) {
 
     m_activeEntry = builder.GetEntry("active");
     m_activeEntry.SetString(m_defaultChoice);
+
+    builder.AddDoubleProperty(
+        "startLatency",
+        [=] { return units::millisecond_t{m_startLatency}.to<double>(); },
+        nullptr);
 }
 
 }  // namespace frc3512
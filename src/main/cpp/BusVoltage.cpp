@@ -0,0 +1,43 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "BusVoltage.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <frc/RobotController.h>
+
+namespace frc3512 {
+
+BusVoltage::BusVoltage(units::second_t timeConstant, units::second_t period)
+    : m_gain{std::exp(-period / timeConstant)} {}
+
+void BusVoltage::Update() {
+    double sample = frc::RobotController::GetInputVoltage();
+    double voltage = m_voltage.load(std::memory_order_relaxed);
+
+    if (m_initialized) {
+        voltage = m_gain * voltage + (1.0 - m_gain) * sample;
+    } else {
+        voltage = sample;
+        m_initialized = true;
+    }
+
+    m_voltage.store(voltage, std::memory_order_relaxed);
+}
+
+units::volt_t BusVoltage::Get() const {
+    return units::volt_t{std::max(m_voltage.load(std::memory_order_relaxed),
+                                  kMinVoltage.to<double>())};
+}
+
+double BusVoltage::GetCompensationScale() const {
+    return kNominalVoltage / Get();
+}
+
+void BusVoltage::SetVoltage(frc::SpeedController& motor,
+                            units::volt_t voltage) const {
+    motor.Set(voltage / Get());
+}
+
+}  // namespace frc3512
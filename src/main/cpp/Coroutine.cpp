@@ -0,0 +1,154 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// ucontext is only exposed by macOS's libc with the X/Open feature macro
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "Coroutine.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+// winbase.h defines a legacy Yield() macro
+#undef Yield
+#else
+#include <ucontext.h>
+#endif
+
+#include "RealTime.hpp"
+
+// macOS deprecates the ucontext API but still implements it
+#ifdef __APPLE__
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+namespace frc3512 {
+
+namespace {
+thread_local Coroutine* tCurrent = nullptr;
+}  // namespace
+
+#ifdef _WIN32
+
+struct Coroutine::Context {
+    void* fiber = nullptr;
+    void* caller = nullptr;
+
+    static void WINAPI Entry(void* param) {
+        Coroutine::Run(static_cast<Coroutine*>(param));
+    }
+};
+
+Coroutine::Coroutine(size_t stackSize) : m_context{new Context} {
+    m_context->fiber = CreateFiber(stackSize, &Context::Entry, this);
+    if (m_context->fiber == nullptr) {
+        throw std::runtime_error{"Coroutine: CreateFiber() failed"};
+    }
+}
+
+Coroutine::~Coroutine() { DeleteFiber(m_context->fiber); }
+
+void Coroutine::Resume() {
+    if (m_done) {
+        return;
+    }
+
+    if (!IsThreadAFiber()) {
+        ConvertThreadToFiber(nullptr);
+    }
+
+    Coroutine* prev = tCurrent;
+    tCurrent = this;
+    m_context->caller = GetCurrentFiber();
+    SwitchToFiber(m_context->fiber);
+    tCurrent = prev;
+
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void Coroutine::Yield() { SwitchToFiber(tCurrent->m_context->caller); }
+
+#else
+
+struct Coroutine::Context {
+    std::unique_ptr<char[]> stack;
+    ucontext_t caller;
+    ucontext_t callee;
+
+    // makecontext() can only pass int arguments, so the coroutine being
+    // entered for the first time is handed over through tCurrent instead
+    static void Entry() { Coroutine::Run(tCurrent); }
+};
+
+Coroutine::Coroutine(size_t stackSize) : m_context{new Context} {
+    m_context->stack.reset(new char[stackSize]);
+
+    // Keep the stack resident so switching to it never page faults
+    LockMemory(m_context->stack.get(), stackSize);
+
+    getcontext(&m_context->callee);
+    m_context->callee.uc_stack.ss_sp = m_context->stack.get();
+    m_context->callee.uc_stack.ss_size = stackSize;
+    m_context->callee.uc_link = nullptr;
+    makecontext(&m_context->callee, &Context::Entry, 0);
+}
+
+Coroutine::~Coroutine() = default;
+
+void Coroutine::Resume() {
+    if (m_done) {
+        return;
+    }
+
+    Coroutine* prev = tCurrent;
+    tCurrent = this;
+    swapcontext(&m_context->caller, &m_context->callee);
+    tCurrent = prev;
+
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void Coroutine::Yield() {
+    Coroutine* self = tCurrent;
+    swapcontext(&self->m_context->callee, &self->m_context->caller);
+}
+
+#endif
+
+void Coroutine::Start(std::function<void()> func) {
+    if (!m_done) {
+        throw std::logic_error{"Coroutine: previous function is still running"};
+    }
+
+    m_func = std::move(func);
+    m_done = false;
+}
+
+bool Coroutine::IsDone() const { return m_done; }
+
+Coroutine* Coroutine::Current() { return tCurrent; }
+
+void Coroutine::Run(Coroutine* coroutine) {
+    // The entry function never returns. Once a function finishes, control goes
+    // back to the caller of Resume() and the next Resume() after Start() picks
+    // up the new function from the top of this loop.
+    while (true) {
+        try {
+            coroutine->m_func();
+        } catch (...) {
+            coroutine->m_exception = std::current_exception();
+        }
+        coroutine->m_func = nullptr;
+        coroutine->m_done = true;
+        Yield();
+    }
+}
+
+}  // namespace frc3512
@@ -0,0 +1,32 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "CoroutinePool.hpp"
+
+namespace frc3512 {
+
+CoroutinePool::CoroutinePool(size_t size, size_t stackSize) {
+    m_coroutines.reserve(size);
+    m_idle.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        m_coroutines.emplace_back(std::make_unique<Coroutine>(stackSize));
+        m_idle.emplace_back(m_coroutines.back().get());
+    }
+}
+
+Coroutine* CoroutinePool::Acquire() {
+    if (m_idle.empty()) {
+        return nullptr;
+    }
+
+    Coroutine* coroutine = m_idle.back();
+    m_idle.pop_back();
+    return coroutine;
+}
+
+void CoroutinePool::Release(Coroutine* coroutine) {
+    m_idle.emplace_back(coroutine);
+}
+
+size_t CoroutinePool::Available() const { return m_idle.size(); }
+
+}  // namespace frc3512
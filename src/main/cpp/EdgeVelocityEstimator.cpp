@@ -0,0 +1,143 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "EdgeVelocityEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+EdgeVelocityEstimator::EdgeVelocityEstimator(size_t windowSize,
+                                             bool fitAcceleration,
+                                             units::second_t maxPeriod)
+    : m_windowSize{std::clamp<size_t>(windowSize, 3, kBufferSize - 1)},
+      m_fitAcceleration{fitAcceleration},
+      m_maxPeriod{maxPeriod} {
+    for (auto& timestamp : m_timestamps) {
+        timestamp.store(0.0, std::memory_order_relaxed);
+    }
+    for (auto& position : m_positions) {
+        position.store(0, std::memory_order_relaxed);
+    }
+}
+
+void EdgeVelocityEstimator::AddEdge(units::second_t timestamp,
+                                    int64_t position) {
+    uint64_t count = m_count.load(std::memory_order_relaxed);
+    m_timestamps[count % kBufferSize].store(timestamp.to<double>(),
+                                            std::memory_order_relaxed);
+    m_positions[count % kBufferSize].store(position,
+                                           std::memory_order_relaxed);
+    m_nextPosition = position + 1;
+    m_count.store(count + 1, std::memory_order_release);
+}
+
+void EdgeVelocityEstimator::AddEdge(units::second_t timestamp) {
+    AddEdge(timestamp, m_nextPosition);
+}
+
+void EdgeVelocityEstimator::Reset() {
+    m_nextPosition = 0;
+    m_count.store(0, std::memory_order_release);
+}
+
+double EdgeVelocityEstimator::GetVelocity(units::second_t now) const {
+    return Calculate(now).velocity;
+}
+
+double EdgeVelocityEstimator::GetAcceleration(units::second_t now) const {
+    return Calculate(now).acceleration;
+}
+
+EdgeVelocityEstimator::Fit EdgeVelocityEstimator::Calculate(
+    units::second_t now) const {
+    std::array<double, kBufferSize> times;
+    std::array<int64_t, kBufferSize> positions;
+    size_t n;
+
+    // Seqlock-style read: if the writer lapped the slots being copied, try
+    // again with the newer edges. AddEdge() overwrites a slot before it
+    // publishes the new count, so the oldest slot copied is only safe if the
+    // count is still less than a full buffer past it.
+    while (true) {
+        uint64_t count = m_count.load(std::memory_order_acquire);
+        n = static_cast<size_t>(std::min<uint64_t>(count, m_windowSize));
+        for (size_t i = 0; i < n; ++i) {
+            size_t slot = (count - n + i) % kBufferSize;
+            times[i] = m_timestamps[slot].load(std::memory_order_relaxed);
+            positions[i] = m_positions[slot].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_count.load(std::memory_order_relaxed) - (count - n) <
+            kBufferSize) {
+            break;
+        }
+    }
+
+    if (n < 3) {
+        return {};
+    }
+
+    double newest = times[n - 1];
+    double sinceNewest = now.to<double>() - newest;
+    if (sinceNewest > m_maxPeriod.to<double>()) {
+        return {};
+    }
+
+    // Fit position against time with the newest edge at the origin. Then the
+    // linear coefficient is the velocity at the newest edge.
+    double s0 = n;
+    double s1 = 0.0;
+    double s2 = 0.0;
+    double s3 = 0.0;
+    double s4 = 0.0;
+    double sy = 0.0;
+    double sxy = 0.0;
+    double sx2y = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = times[i] - newest;
+        double y = static_cast<double>(positions[i] - positions[n - 1]);
+        double x2 = x * x;
+        s1 += x;
+        s2 += x2;
+        s3 += x2 * x;
+        s4 += x2 * x2;
+        sy += y;
+        sxy += x * y;
+        sx2y += x2 * y;
+    }
+
+    Fit fit;
+    if (m_fitAcceleration) {
+        // Solve the 3x3 normal equations for y = c0 + c1 x + c2 x² with
+        // Cramer's rule
+        double det = s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) +
+                     s2 * (s1 * s3 - s2 * s2);
+        if (det == 0.0) {
+            return {};
+        }
+        double det1 = s0 * (sxy * s4 - s3 * sx2y) -
+                      sy * (s1 * s4 - s3 * s2) + s2 * (s1 * sx2y - sxy * s2);
+        double det2 = s0 * (s2 * sx2y - sxy * s3) -
+                      s1 * (s1 * sx2y - sxy * s2) + sy * (s1 * s3 - s2 * s2);
+        fit.velocity = det1 / det;
+        fit.acceleration = 2.0 * det2 / det;
+    } else {
+        double det = s0 * s2 - s1 * s1;
+        if (det == 0.0) {
+            return {};
+        }
+        fit.velocity = (s0 * sxy - s1 * sy) / det;
+    }
+
+    // If it's been longer since the last edge than the fit predicts between
+    // edges, the wheel has slowed down since then. It can't be moving faster
+    // than one edge per time since the last one.
+    if (sinceNewest > 0.0) {
+        double bound = 1.0 / sinceNewest;
+        if (std::abs(fit.velocity) > bound) {
+            fit.velocity = std::copysign(bound, fit.velocity);
+        }
+    }
+
+    return fit;
+}
@@ -1,16 +1,61 @@
-// Copyright (c) 2013-2020 FRC Team 3512. All Rights Reserved.
+// Copyright (c) 2013-2021 FRC Team 3512. All Rights Reserved.
 
 #include "GeartoothEncoder.hpp"
 
+#include <frc2/Timer.h>
+#include <units/time.h>
+
 GeartoothEncoder::GeartoothEncoder(int channel, int teethPerRevolution,
-                                   double gearRatio)
-    : m_counter{channel},
+                                   double gearRatio, EstimationMode mode)
+    : m_input{channel},
       m_teethPerRevolution{teethPerRevolution},
-      m_gearRatio{gearRatio} {
+      m_gearRatio{gearRatio},
+      m_mode{mode},
+      m_simDevice{"GeartoothEncoder", channel} {
     m_counter.SetSamplesToAverage(5);
+
+    if (m_simDevice) {
+        m_simRate =
+            m_simDevice.CreateDouble("rate", hal::SimDevice::kInput, 0.0);
+    }
+
+    if (m_mode == EstimationMode::kEdgeTimestamps) {
+        m_input.RequestInterrupts(
+            [=](frc::InterruptableSensorBase::WaitResult) {
+                // The handler can wake up after more than one edge period,
+                // so the edge's position comes from the FPGA's count instead
+                // of counting interrupts. A late wakeup then only shifts
+                // this edge's position by the edges since, rather than
+                // dropping an edge from every later period.
+                m_estimator.AddEdge(
+                    units::second_t{m_input.ReadRisingTimestamp()},
+                    m_counter.Get());
+            });
+        m_input.SetUpSourceEdge(true, false);
+        m_input.EnableInterrupts();
+    }
+}
+
+GeartoothEncoder::~GeartoothEncoder() {
+    if (m_mode == EstimationMode::kEdgeTimestamps) {
+        m_input.CancelInterrupts();
+    }
 }
 
 units::revolutions_per_minute_t GeartoothEncoder::GetRate() const {
+    if (m_simRate) {
+        return units::revolutions_per_minute_t{m_simRate.Get()};
+    }
+
+    if (m_mode == EstimationMode::kEdgeTimestamps) {
+        // gear teeth per second = edge rate
+        // shooter wheel RPM = kGearRatio * 60 * edge rate / kTicksPerRev
+        return units::revolutions_per_minute_t{
+            m_gearRatio * 60.0 *
+            m_estimator.GetVelocity(frc2::Timer::GetFPGATimestamp()) /
+            m_teethPerRevolution};
+    }
+
     // Derivation of RPM:
     // gear seconds per tick = period
     // gear ticks per second = 1 / period
@@ -20,3 +65,5 @@ units::revolutions_per_minute_t GeartoothEncoder::GetRate() const {
     return units::revolutions_per_minute_t{
         m_gearRatio * 60.0 / (m_teethPerRevolution * m_counter.GetPeriod())};
 }
+
+int GeartoothEncoder::GetChannel() const { return m_input.GetChannel(); }
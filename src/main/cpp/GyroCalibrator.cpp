@@ -0,0 +1,239 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "GyroCalibrator.hpp"
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+#include <fmt/os.h>
+#include <frc/Filesystem.h>
+#include <frc/RobotBase.h>
+#include <frc2/Timer.h>
+#include <units/angle.h>
+#include <units/math.h>
+#include <wpi/Path.h>
+#include <wpi/SmallString.h>
+#include <wpi/json.h>
+
+#include "telemetry/ConsoleLog.hpp"
+
+namespace {
+
+/**
+ * Flushes a file's contents to disk.
+ */
+bool SyncFile(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+/**
+ * Renames a file over another and flushes the rename to disk.
+ */
+bool ReplaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    // std::rename() fails on Windows if the destination exists
+    return MoveFileExA(from.c_str(), to.c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (std::rename(from.c_str(), to.c_str()) != 0) {
+        return false;
+    }
+
+    // The rename is only durable once the directory holding it is flushed
+    std::string directory = wpi::sys::path::parent_path(to).str();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+}  // namespace
+
+GyroCalibrator::GyroCalibrator(int channel, std::string path)
+    : m_path{std::move(path)},
+      m_saved{Load(m_path)},
+      m_input{std::make_shared<frc::AnalogInput>(channel)},
+      m_gyro{m_input, m_saved ? m_saved->center : 0,
+             m_saved ? m_saved->offset : 0.0} {
+    if (m_saved) {
+        auto drift = MeasureDrift();
+        if (units::math::abs(drift) <= kMaxDriftRate) {
+            frc3512::Log(
+                FMT_COMPILE("Gyro: using saved calibration ({:.3f} deg/s "
+                            "drift)\n"),
+                drift.to<double>());
+            return;
+        }
+
+        frc3512::Log(FMT_COMPILE("Gyro: saved calibration drifts at {:.3f} "
+                                 "deg/s; recalibrating\n"),
+                     drift.to<double>());
+    }
+
+    m_gyro.Calibrate();
+
+    if (!m_path.empty()) {
+        Save({m_gyro.GetCenter(), m_gyro.GetOffset()});
+    }
+}
+
+std::string GyroCalibrator::GetDefaultPath() {
+    // Simulations construct many robots, so only the real robot persists it
+    if constexpr (!frc::RobotBase::IsReal()) {
+        return "";
+    }
+
+    wpi::SmallString<64> path;
+    frc::filesystem::GetOperatingDirectory(path);
+    wpi::sys::path::append(path, "gyro-calibration.json");
+    return path.str();
+}
+
+frc::AnalogGyro& GyroCalibrator::GetGyro() { return m_gyro; }
+
+void GyroCalibrator::StartBackgroundCalibration() {
+    m_backgroundDone = m_path.empty();
+    m_backgroundActive = false;
+}
+
+void GyroCalibrator::UpdateBackgroundCalibration(bool stationary) {
+    if (m_backgroundDone) {
+        return;
+    }
+
+    if (!stationary) {
+        m_backgroundActive = false;
+        return;
+    }
+
+    int64_t value;
+    int64_t count;
+    m_input->GetAccumulatorOutput(value, count);
+
+    if (!m_backgroundActive) {
+        m_backgroundActive = true;
+        m_backgroundStartTime = frc2::Timer::GetFPGATimestamp();
+        m_startValue = value;
+        m_startCount = count;
+        return;
+    }
+
+    if (frc2::Timer::GetFPGATimestamp() - m_backgroundStartTime <
+            kCalibrationTime ||
+        count <= m_startCount) {
+        return;
+    }
+    m_backgroundDone = true;
+
+    // The accumulator sums each sample minus the gyro's center, so the
+    // average sample is the center plus the average accumulated value. This
+    // is the same average AnalogGyro::Calibrate() splits into a center and
+    // offset.
+    double average = m_gyro.GetCenter() +
+                     static_cast<double>(value - m_startValue) /
+                         static_cast<double>(count - m_startCount);
+    Calibration calibration;
+    calibration.center = static_cast<int>(std::lround(average));
+    calibration.offset = average - calibration.center;
+
+    if (!m_saved || m_saved->center != calibration.center ||
+        std::abs(m_saved->offset - calibration.offset) > 1e-3) {
+        Save(calibration);
+    }
+}
+
+std::optional<GyroCalibrator::Calibration> GyroCalibrator::Load(
+    const std::string& path) {
+    if (path.empty()) {
+        return std::nullopt;
+    }
+
+    std::ifstream file{path};
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    try {
+        auto json = wpi::json::parse(contents.str());
+        return Calibration{json.at("center").get<int>(),
+                           json.at("offset").get<double>()};
+    } catch (const wpi::json::exception& e) {
+        frc3512::LogError(FMT_COMPILE("Gyro: {}: {}; ignoring it\n"), path,
+                          e.what());
+        return std::nullopt;
+    }
+}
+
+void GyroCalibrator::Save(const Calibration& calibration) {
+    // Write a temporary file, flush it to disk, and rename it over the old
+    // one, which is atomic, so a brownout at any point leaves either the old
+    // or the new calibration
+    std::string temporaryPath = m_path + ".tmp";
+    std::string contents =
+        fmt::format("{{\n  \"center\": {},\n  \"offset\": {}\n}}\n",
+                    calibration.center, calibration.offset);
+    try {
+        // fmt's default flags don't truncate an existing file
+        fmt::file file{temporaryPath,
+                       fmt::file::WRONLY | fmt::file::CREATE | O_TRUNC};
+        if (file.write(contents.data(), contents.size()) != contents.size() ||
+            !SyncFile(file.descriptor())) {
+            throw std::system_error{errno, std::generic_category(),
+                                    "couldn't write " + temporaryPath};
+        }
+        file.close();
+    } catch (const std::system_error& e) {
+        frc3512::LogError(FMT_COMPILE("Gyro: couldn't save calibration: {}\n"),
+                          e.what());
+        return;
+    }
+
+    if (!ReplaceFile(temporaryPath, m_path)) {
+        frc3512::LogError(FMT_COMPILE("Gyro: couldn't replace {}\n"), m_path);
+        return;
+    }
+
+    m_saved = calibration;
+    frc3512::Log(FMT_COMPILE("Gyro: saved calibration (center {}, offset "
+                             "{:.4f})\n"),
+                 calibration.center, calibration.offset);
+}
+
+units::degrees_per_second_t GyroCalibrator::MeasureDrift() {
+    double startAngle = m_gyro.GetAngle();
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(kDriftCheckTime.to<double>()));
+    return units::degree_t{m_gyro.GetAngle() - startAngle} / kDriftCheckTime;
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <wpi/MathExtras.h>
+
+using namespace frc3512;
+
+namespace {
+
+// Each power of two is split into 2^kSubBucketBits buckets
+constexpr unsigned int kSubBucketBits = 3;
+constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+
+// Durations are clamped below 2^kMaxExponent
+constexpr unsigned int kMaxExponent = 28;
+
+static_assert((kMaxExponent - kSubBucketBits + 1) * kSubBuckets ==
+                  LatencyHistogram::kNumBuckets,
+              "kNumBuckets doesn't match the bucket layout");
+
+}  // namespace
+
+double LatencyHistogram::Window::Mean() const {
+    if (count == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(sum) / count;
+}
+
+uint64_t LatencyHistogram::Window::Percentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(
+        std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * count));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // The next bucket's lower bound is this one's exclusive upper
+            // bound. The window's extremes are exact, so they tighten it.
+            uint64_t upper = i + 1 < kNumBuckets ? BucketLowerBound(i + 1) - 1
+                                                 : max;
+            return std::clamp(upper, min, max);
+        }
+    }
+    return max;
+}
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds) {
+    auto& bucket = m_buckets[BucketIndex(nanoseconds)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    m_sum.store(m_sum.load(std::memory_order_relaxed) + nanoseconds,
+                std::memory_order_relaxed);
+
+    if (nanoseconds < m_min.load(std::memory_order_relaxed)) {
+        m_min.store(nanoseconds, std::memory_order_relaxed);
+    }
+    if (nanoseconds > m_max.load(std::memory_order_relaxed)) {
+        m_max.store(nanoseconds, std::memory_order_relaxed);
+    }
+
+    // Published last so a reader that sees the count sees the buckets too
+    m_count.store(m_count.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+}
+
+LatencyHistogram::Window LatencyHistogram::TakeWindow() {
+    Window window;
+
+    uint32_t count = m_count.load(std::memory_order_acquire);
+    window.count = count - m_lastCount;
+    m_lastCount = count;
+
+    uint64_t sum = m_sum.load(std::memory_order_relaxed);
+    window.sum = sum - m_lastSum;
+    m_lastSum = sum;
+
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        uint32_t bucket = m_buckets[i].load(std::memory_order_relaxed);
+        window.buckets[i] = bucket - m_lastBuckets[i];
+        m_lastBuckets[i] = bucket;
+    }
+
+    uint64_t min = m_min.exchange(std::numeric_limits<uint64_t>::max(),
+                                  std::memory_order_relaxed);
+    uint64_t max = m_max.exchange(0, std::memory_order_relaxed);
+    if (window.count > 0) {
+        window.min = std::min(min, max);
+        window.max = max;
+    }
+
+    return window;
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t nanoseconds) {
+    nanoseconds = std::min(nanoseconds, (uint64_t{1} << kMaxExponent) - 1);
+    if (nanoseconds < kSubBuckets) {
+        return static_cast<size_t>(nanoseconds);
+    }
+
+    // The top kSubBucketBits + 1 bits select the bucket
+    unsigned int exponent = wpi::Log2_64(nanoseconds);
+    unsigned int shift = exponent - kSubBucketBits;
+    return (shift + 1) * kSubBuckets +
+           ((nanoseconds >> shift) & (kSubBuckets - 1));
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+
+    uint64_t shift = index / kSubBuckets - 1;
+    return (kSubBuckets + index % kSubBuckets) << shift;
+}
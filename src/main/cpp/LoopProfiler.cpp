@@ -0,0 +1,146 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "LoopProfiler.hpp"
+
+#include <fmt/compile.h>
+#include <fmt/core.h>
+#include <networktables/NetworkTable.h>
+#include <networktables/NetworkTableInstance.h>
+
+#include "telemetry/ConsoleLog.hpp"
+
+using namespace frc3512;
+
+namespace {
+
+uint64_t ToNanoseconds(LoopProfiler::Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+        .count();
+}
+
+double ToMicroseconds(double nanoseconds) { return nanoseconds / 1000.0; }
+
+}  // namespace
+
+LoopProfiler::ScopedProbe::ScopedProbe(LoopProfiler& profiler, size_t stage)
+    : m_profiler{profiler}, m_stage{stage}, m_start{Clock::now()} {}
+
+LoopProfiler::ScopedProbe::~ScopedProbe() {
+    m_profiler.RecordStage(m_stage, ToNanoseconds(Clock::now() - m_start));
+}
+
+LoopProfiler::ScopedLoop::ScopedLoop(LoopProfiler& profiler)
+    : m_profiler{profiler} {
+    m_profiler.StartLoop();
+    m_start = Clock::now();
+}
+
+LoopProfiler::ScopedLoop::~ScopedLoop() {
+    m_profiler.EndLoop(ToNanoseconds(Clock::now() - m_start));
+}
+
+LoopProfiler::LoopProfiler(wpi::StringRef name,
+                           std::initializer_list<std::string> stageNames,
+                           units::second_t budget,
+                           units::second_t publishPeriod)
+    : m_name{name},
+      m_budget{static_cast<uint64_t>(budget.to<double>() * 1e9)} {
+    for (const auto& stageName : stageNames) {
+        AddStage(stageName);
+    }
+    AddStage("Total");
+
+    m_publisher.StartPeriodic(publishPeriod);
+}
+
+LoopProfiler::ScopedLoop LoopProfiler::ProfileLoop() {
+    return ScopedLoop{*this};
+}
+
+LoopProfiler::ScopedProbe LoopProfiler::Probe(size_t stage) {
+    return ScopedProbe{*this, stage};
+}
+
+void LoopProfiler::AddStage(const std::string& name) {
+    auto table = nt::NetworkTableInstance::GetDefault()
+                     .GetTable("LoopTiming")
+                     ->GetSubTable(m_name)
+                     ->GetSubTable(name);
+
+    auto stage = std::make_unique<Stage>();
+    stage->name = name;
+    stage->minEntry = table->GetEntry("Min (us)");
+    stage->meanEntry = table->GetEntry("Mean (us)");
+    stage->p99Entry = table->GetEntry("P99 (us)");
+    stage->maxEntry = table->GetEntry("Max (us)");
+    stage->overrunsEntry = table->GetEntry("Overruns");
+    m_stages.emplace_back(std::move(stage));
+}
+
+void LoopProfiler::StartLoop() {
+    for (auto& stage : m_stages) {
+        stage->loopTime = 0;
+    }
+}
+
+void LoopProfiler::EndLoop(uint64_t nanoseconds) {
+    auto& total = *m_stages.back();
+    total.histogram.Record(nanoseconds);
+
+    if (nanoseconds <= m_budget) {
+        return;
+    }
+
+    total.overruns.store(total.overruns.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+
+    // Attribute the overrun to the slowest stage
+    Stage* slowest = nullptr;
+    for (size_t i = 0; i + 1 < m_stages.size(); ++i) {
+        if (slowest == nullptr || m_stages[i]->loopTime > slowest->loopTime) {
+            slowest = m_stages[i].get();
+        }
+    }
+    if (slowest != nullptr && slowest->loopTime > 0) {
+        slowest->overruns.store(
+            slowest->overruns.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+    }
+}
+
+void LoopProfiler::RecordStage(size_t stage, uint64_t nanoseconds) {
+    auto& s = *m_stages[stage];
+    s.histogram.Record(nanoseconds);
+    s.loopTime += nanoseconds;
+}
+
+void LoopProfiler::Publish() {
+    uint32_t totalOverruns = 0;
+    std::string attribution;
+
+    for (auto& stage : m_stages) {
+        auto window = stage->histogram.TakeWindow();
+        stage->minEntry.SetDouble(ToMicroseconds(window.min));
+        stage->meanEntry.SetDouble(ToMicroseconds(window.Mean()));
+        stage->p99Entry.SetDouble(ToMicroseconds(window.Percentile(99.0)));
+        stage->maxEntry.SetDouble(ToMicroseconds(window.max));
+
+        uint32_t overruns = stage->overruns.load(std::memory_order_relaxed);
+        stage->overrunsEntry.SetDouble(overruns);
+
+        uint32_t newOverruns = overruns - stage->lastOverruns;
+        stage->lastOverruns = overruns;
+        if (stage == m_stages.back()) {
+            totalOverruns = newOverruns;
+        } else if (newOverruns > 0) {
+            attribution += fmt::format("{}{}: {}",
+                                       attribution.empty() ? "" : ", ",
+                                       stage->name, newOverruns);
+        }
+    }
+
+    if (totalOverruns > 0) {
+        Log(FMT_COMPILE("{} loop overran {} time(s) since last report ({})\n"),
+            m_name, totalOverruns, attribution);
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#ifdef _WIN32
+
+// Windows' read-ahead doesn't take hints for mapped files, so the access
+// pattern is unused
+MappedFile::MappedFile(const std::string& path, Access) {
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error{fmt::format("couldn't open {}", path)};
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size)) {
+        CloseHandle(m_file);
+        throw std::runtime_error{fmt::format("couldn't read size of {}", path)};
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) {
+        return;
+    }
+
+    m_mapping =
+        CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr) {
+        m_data = static_cast<const uint8_t*>(
+            MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (m_data == nullptr) {
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+        CloseHandle(m_file);
+        throw std::runtime_error{fmt::format("couldn't map {}", path)};
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path, Access access) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error{fmt::format("couldn't open {}", path)};
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        throw std::runtime_error{fmt::format("couldn't read size of {}", path)};
+    }
+    m_size = static_cast<size_t>(status.st_size);
+
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error{fmt::format("couldn't map {}", path)};
+        }
+        m_data = static_cast<const uint8_t*>(data);
+
+        // Sequential read-ahead also lets the kernel drop pages behind the
+        // reader, which a file read for its whole lifetime shouldn't allow
+        madvise(data, m_size,
+                access == Access::kSequential ? MADV_SEQUENTIAL
+                                              : MADV_WILLNEED);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+}
+
+#endif
+
+const uint8_t* MappedFile::Data() const { return m_data; }
+
+size_t MappedFile::Size() const { return m_size; }
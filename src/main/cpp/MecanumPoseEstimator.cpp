@@ -0,0 +1,107 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "MecanumPoseEstimator.hpp"
+
+#include <units/velocity.h>
+
+MecanumPoseEstimator::MecanumPoseEstimator(
+    const frc::Encoder& frontLeftEncoder, const frc::Encoder& rearLeftEncoder,
+    const frc::Encoder& frontRightEncoder, const frc::Encoder& rearRightEncoder,
+    frc::AnalogGyro& gyro, units::second_t period)
+    : m_encoders{&frontLeftEncoder, &rearLeftEncoder, &frontRightEncoder,
+                 &rearRightEncoder},
+      m_gyro{gyro} {
+    {
+        std::scoped_lock lock{m_mutex};
+        ResetSensors();
+    }
+
+    m_notifier.StartPeriodic(period);
+}
+
+frc::Pose2d MecanumPoseEstimator::GetPose() const {
+    while (true) {
+        uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+        if (sequence % 2 == 1) {
+            continue;
+        }
+
+        double x = m_x.load(std::memory_order_relaxed);
+        double y = m_y.load(std::memory_order_relaxed);
+        double heading = m_heading.load(std::memory_order_relaxed);
+
+        // Keep the reads above from moving past the check
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+            return frc::Pose2d{units::meter_t{x}, units::meter_t{y},
+                               units::radian_t{heading}};
+        }
+    }
+}
+
+void MecanumPoseEstimator::ResetPose(const frc::Pose2d& pose) {
+    std::scoped_lock lock{m_mutex};
+
+    ResetSensors();
+    m_headingOffset = pose.Rotation().Radians();
+    m_pose = pose;
+    Publish();
+}
+
+void MecanumPoseEstimator::ResetHeading() {
+    std::scoped_lock lock{m_mutex};
+
+    ResetSensors();
+    m_headingOffset = 0_rad;
+    m_pose = frc::Pose2d{m_pose.X(), m_pose.Y(), 0_rad};
+    Publish();
+}
+
+void MecanumPoseEstimator::Update() {
+    std::scoped_lock lock{m_mutex};
+
+    // Distance each wheel traveled since the last update, passed to the
+    // kinematics as the speed over one second
+    std::array<units::meters_per_second_t, kWheels> deltas;
+    for (int i = 0; i < kWheels; ++i) {
+        units::inch_t distance{m_encoders[i]->GetDistance()};
+        deltas[i] = (distance - m_lastDistances[i]) / 1_s;
+        m_lastDistances[i] = distance;
+    }
+    auto chassisDelta =
+        m_kinematics.ToChassisSpeeds({deltas[0], deltas[2], deltas[1],
+                                      deltas[3]});
+
+    // The gyro's angle is clockwise positive
+    frc::Rotation2d heading{-units::degree_t{m_gyro.GetAngle()} +
+                            m_headingOffset};
+
+    // Integrate along an arc to the gyro's heading rather than the wheels'
+    // rotation, which slips more
+    auto pose = m_pose.Exp({chassisDelta.vx * 1_s, chassisDelta.vy * 1_s,
+                            (heading - m_pose.Rotation()).Radians()});
+    m_pose = frc::Pose2d{pose.X(), pose.Y(), heading};
+    Publish();
+}
+
+void MecanumPoseEstimator::ResetSensors() {
+    m_gyro.Reset();
+    for (int i = 0; i < kWheels; ++i) {
+        m_lastDistances[i] = units::inch_t{m_encoders[i]->GetDistance()};
+    }
+}
+
+void MecanumPoseEstimator::Publish() {
+    uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+
+    // Keep the writes below from moving before the odd sequence number
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_x.store(m_pose.X().to<double>(), std::memory_order_relaxed);
+    m_y.store(m_pose.Y().to<double>(), std::memory_order_relaxed);
+    m_heading.store(m_pose.Rotation().Radians().to<double>(),
+                    std::memory_order_relaxed);
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "RealTime.hpp"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace frc3512 {
+
+namespace {
+constexpr size_t kPrefaultChunkSize = 16 * 1024;
+
+// Touches kPrefaultChunkSize bytes of stack per call and recurses until the
+// requested size is covered. Separate frames keep any single frame small.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void PrefaultStackChunk(size_t remaining) {
+    volatile char chunk[kPrefaultChunkSize];
+    std::memset(const_cast<char*>(chunk), 0, sizeof(chunk));
+    LockMemory(const_cast<char*>(chunk), sizeof(chunk));
+
+    if (remaining > kPrefaultChunkSize) {
+        PrefaultStackChunk(remaining - kPrefaultChunkSize);
+    }
+
+    // Keep the frame alive until the recursion unwinds
+    chunk[0] = chunk[0];
+}
+}  // namespace
+
+void PrefaultStack(size_t size) { PrefaultStackChunk(size); }
+
+void LockMemory(void* data, size_t size) {
+    std::memset(data, 0, size);
+#ifdef _WIN32
+    VirtualLock(data, size);
+#else
+    mlock(data, size);
+#endif
+}
+
+bool LockPages(const void* data, size_t size) {
+#ifdef _WIN32
+    return VirtualLock(const_cast<void*>(data), size) != 0;
+#else
+    return mlock(data, size) == 0;
+#endif
+}
+
+int GetCurrentCpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+bool PinThreadToCpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+    if (cpu < 0) {
+        return false;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpus),
+                                  &cpus) == 0;
+#else
+    return false;
+#endif
+}
+
+bool SetCurrentThreadBackground() {
+#if defined(__linux__)
+    // Linux applies nice values to individual threads
+    constexpr int kNiceValue = 10;
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)),
+                       kNiceValue) == 0;
+#elif defined(_WIN32)
+    return SetThreadPriority(GetCurrentThread(),
+                             THREAD_PRIORITY_BELOW_NORMAL) != 0;
+#else
+    return false;
+#endif
+}
+
+}  // namespace frc3512
@@ -2,6 +2,78 @@
 
 #include "Robot.hpp"
 
+#include <cmath>
+#include <cstdint>
+
+#include <frc/DriverStation.h>
+#include <frc/Filesystem.h>
+#include <frc/RobotBase.h>
+#include <frc/RobotController.h>
+#include <frc/simulation/AnalogGyroSim.h>
+#include <frc/simulation/BatterySim.h>
+#include <frc/simulation/DriverStationSim.h>
+#include <frc/simulation/EncoderSim.h>
+#include <frc/simulation/RoboRioSim.h>
+#include <frc2/Timer.h>
+#include <units/length.h>
+#include <units/voltage.h>
+#include <wpi/Path.h>
+#include <wpi/SmallString.h>
+
+namespace {
+
+// Joystick axes logged in InputRecord. The Z axis is also the twist axis.
+constexpr int kXAxis = frc::Joystick::kDefaultXChannel;
+constexpr int kYAxis = frc::Joystick::kDefaultYChannel;
+constexpr int kZAxis = frc::Joystick::kDefaultZChannel;
+constexpr int kLoggedAxes = kZAxis + 1;
+
+// How long telemetry keeps logging after the robot is disabled, so logs cover
+// the transition between autonomous and teleop and the end of a match
+constexpr units::second_t kDisabledLogTime = 5_s;
+
+// Fastest wheel speed in inches per second at which the robot is considered
+// stationary for the gyro's background calibration
+constexpr double kStationaryWheelSpeed = 0.5;
+
+/**
+ * Returns a joystick axis, or zero if the joystick doesn't have it.
+ *
+ * Unlike Joystick::GetRawAxis(), a missing axis isn't reported as an error,
+ * since the inputs are logged in every mode.
+ */
+float GetLoggedAxis(const frc::Joystick& stick, int axis) {
+    auto& ds = frc::DriverStation::GetInstance();
+    if (axis >= ds.GetStickAxisCount(stick.GetPort())) {
+        return 0.0f;
+    }
+    return static_cast<float>(ds.GetStickAxis(stick.GetPort(), axis));
+}
+
+void SetSimulatedStick(const frc::Joystick& stick, float x, float y, float z,
+                       uint32_t buttons) {
+    int port = stick.GetPort();
+    frc::sim::DriverStationSim::SetJoystickAxisCount(port, kLoggedAxes);
+    frc::sim::DriverStationSim::SetJoystickAxis(port, kXAxis, x);
+    frc::sim::DriverStationSim::SetJoystickAxis(port, kYAxis, y);
+    frc::sim::DriverStationSim::SetJoystickAxis(port, kZAxis, z);
+
+    // Every button that fits in the logged bitmask
+    frc::sim::DriverStationSim::SetJoystickButtonCount(port, 32);
+    frc::sim::DriverStationSim::SetJoystickButtons(port, buttons);
+}
+
+/**
+ * Returns a drive wheel's velocity in meters per second.
+ *
+ * The encoders' distances are in inches.
+ */
+double GetWheelVelocity(const frc::Encoder& encoder) {
+    return units::meter_t{units::inch_t{encoder.GetRate()}}.to<double>();
+}
+
+}  // namespace
+
 double ScaleZ(frc::Joystick& stick) {
     return std::floor(500.0 * (1.0 - stick.GetZ()) / 2.0) /
            500.0;  // CONSTANT^-1 is step value (now 1/500)
@@ -13,95 +85,253 @@ Robot::Robot() {
     m_rlEncoder.SetDistancePerPulse(60.0 / 250.0);
     m_rrEncoder.SetDistancePerPulse(60.0 / 250.0);
 
+    wpi::SmallString<64> trajectoryPath;
+    frc::filesystem::GetDeployDirectory(trajectoryPath);
+    wpi::sys::path::append(trajectoryPath, "trajectories.bin");
+    m_trajectories.Load(trajectoryPath.str());
+
     m_autonChooser.AddAutonomous("CenterMove", [=] { AutonCenterMove(); });
     m_autonChooser.AddAutonomous("RightMove", [=] { AutonRightMove(); });
     m_autonChooser.AddAutonomous("LeftMove", [=] { AutonLeftMove(); });
     m_autonChooser.AddAutonomous("TwoDisc", [=] { AutonTwoDisc(); });
+    m_autonChooser.SetTelemetry(m_telemetry);
+
+    // Simulations construct many robots, so only the real robot logs. Old
+    // logs are deleted to make room, and logging is paused until the robot is
+    // first enabled.
+    if constexpr (frc::RobotBase::IsReal()) {
+        wpi::SmallString<64> directory;
+        frc::filesystem::GetOperatingDirectory(directory);
+        auto path = frc3512::TelemetryLogger::MakeLogPath(directory.str());
+        if (!path.empty()) {
+            m_telemetry.SetPaused(true);
+            m_telemetry.Start(path);
+        }
+    }
+}
+
+void Robot::RobotPeriodic() {
+    // A powered-on robot can sit disabled for a long time between matches, so
+    // logging pauses a while after it's disabled to save storage
+    auto now = frc2::Timer::GetFPGATimestamp();
+    if (IsEnabled()) {
+        m_lastEnabledTime = now;
+    }
+    m_telemetry.SetPaused(!m_lastEnabledTime ||
+                          now - *m_lastEnabledTime > kDisabledLogTime);
+
+    m_busVoltage.Update();
+
+    // Scale the drive's duty cycles so a given command produces the same
+    // wheel voltage regardless of the battery's state of charge. Commands that
+    // scale past full output saturate in the motor controllers.
+    m_drive.SetMaxOutput(m_busVoltage.GetCompensationScale());
+
+    m_inputTelemetry.Log(GetInputs());
+    m_outputTelemetry.Log(GetOutputs());
 }
 
-void Robot::AutonomousInit() { m_gyro.Reset(); }
+void Robot::SimulationPeriodic() {
+    if (!m_simPhysicsEnabled) {
+        return;
+    }
+
+    m_driveSim.Update(GetPeriod());
+
+    // The shooter's model is stepped by its own controller thread
+    frc::sim::RoboRioSim::SetVInVoltage(frc::sim::BatterySim::Calculate(
+        m_simBatteryVoltage, m_simBatteryResistance,
+        {m_driveSim.GetCurrentDraw(), m_shooter.GetSimulatedCurrentDraw()}));
+}
+
+void Robot::AutonomousInit() {
+    auto initTimestamp = frc2::Timer::GetFPGATimestamp();
+
+    m_poseEstimator.ResetPose();
+    m_driveController.Reset();
+    m_autonChooser.AwaitStartAutonomous(initTimestamp);
+}
 
 void Robot::AutonomousPeriodic() {
-    m_autonChooser.AwaitRunAutonomous();
+    auto loop = m_loopProfiler.ProfileLoop();
 
-    // Updates state of feed actuators
-    m_feeder.Update();
-    m_shooter.Update();
+    {
+        auto probe = m_loopProfiler.Probe(kAutonomous);
+        m_autonChooser.AwaitRunAutonomous();
+    }
+
+    {
+        // Updates state of feed actuators
+        auto probe = m_loopProfiler.Probe(kFeeder);
+        m_feeder.Update();
+    }
 }
 
 void Robot::TeleopInit() {
-    m_gyro.Reset();
+    m_autonChooser.EndAutonomous();
+    m_poseEstimator.ResetHeading();
+    m_driveController.Reset();
     SetUnderglowColor(UnderglowColor::kBlue);
 }
 
 void Robot::TeleopPeriodic() {
-    if (m_shootStick.GetRawButtonPressed(4)) {
-        m_shooter.Enable();
-    } else if (m_shootStick.GetRawButtonPressed(5)) {
-        m_shooter.Disable();
-    }
+    auto loop = m_loopProfiler.ProfileLoop();
 
-    if (m_shooter.IsEnabled()) {
-        m_shooter.SetReference(ScaleZ(m_shootStick) * Shooter::kMaxSpeed);
-    }
+    // Read every input up front so the time spent in the Driver Station API
+    // is attributed separately from the actuators
+    bool shooterEnable;
+    bool shooterDisable;
+    double shooterScale;
+    bool shooterHigh;
+    bool shooterLow;
+    bool shoot;
+    bool climbArmsUp;
+    bool climbArmsDown;
+    bool gyroReset;
+    bool gyroEnable;
+    bool gyroDisable;
+    double driveX;
+    double driveY;
+    double joyTwist;
+    double driveScale;
+    {
+        auto probe = m_loopProfiler.Probe(kJoysticks);
 
-    if (m_shootStick.GetRawButtonPressed(2)) {
-        SetShooterAngle(ShooterAngle::kHigh);
-    }
+        shooterEnable = m_shootStick.GetRawButtonPressed(4);
+        shooterDisable = !shooterEnable && m_shootStick.GetRawButtonPressed(5);
+        shooterScale = ScaleZ(m_shootStick);
+        shooterHigh = m_shootStick.GetRawButtonPressed(2);
+        shooterLow = m_shootStick.GetRawButtonPressed(3);
 
-    if (m_shootStick.GetRawButtonPressed(3)) {
-        SetShooterAngle(ShooterAngle::kLow);
-    }
+        // The trigger is only read once the shooter is ready so a press is
+        // held until then. Enabling or disabling the shooter clears its
+        // at-reference flag.
+        shoot = !shooterEnable && !shooterDisable && m_shooter.AtReference() &&
+                m_shootStick.GetRawButtonPressed(1);
 
-    if (m_shooter.AtReference() && m_shootStick.GetRawButtonPressed(1)) {
-        // Shoot frisbee
-        m_feeder.Activate();
-    }
+        climbArmsUp = m_shootStick.GetRawButtonPressed(6);
+        climbArmsDown = m_shootStick.GetRawButtonPressed(7);
 
-    // Updates state of feed actuators
-    m_feeder.Update();
-    m_shooter.Update();
+        gyroReset = m_driveStick.GetRawButtonPressed(8);
+        gyroEnable = m_driveStick.GetRawButtonPressed(5);
+        gyroDisable = m_driveStick.GetRawButtonPressed(6);
 
-    if (m_shootStick.GetRawButtonPressed(6)) {
-        // Climbing arms up
-        m_climbArms.Set(true);
+        driveX = m_driveStick.GetX();
+        driveY = m_driveStick.GetY();
+        joyTwist = m_driveStick.GetTwist();
+        driveScale = ScaleZ(m_driveStick);
     }
 
-    if (m_shootStick.GetRawButtonPressed(7)) {
-        // Climbing arms down
-        m_climbArms.Set(false);
-    }
+    {
+        auto probe = m_loopProfiler.Probe(kShooter);
 
-    if (m_driveStick.GetRawButtonPressed(8)) {
-        m_gyro.Reset();
+        if (shooterEnable) {
+            m_shooter.Enable();
+        } else if (shooterDisable) {
+            m_shooter.Disable();
+        }
+
+        if (m_shooter.IsEnabled()) {
+            m_shooter.SetReference(shooterScale * Shooter::kMaxSpeed);
+        }
     }
 
-    if (m_driveStick.GetRawButtonPressed(5)) {
-        m_isGyroEnabled = true;
-        SetUnderglowColor(UnderglowColor::kBlue);
+    {
+        auto probe = m_loopProfiler.Probe(kFeeder);
+
+        if (shoot) {
+            // Shoot frisbee
+            m_feeder.Activate();
+        }
+
+        // Updates state of feed actuators
+        m_feeder.Update();
     }
 
-    if (m_driveStick.GetRawButtonPressed(6)) {
-        m_isGyroEnabled = false;
-        SetUnderglowColor(UnderglowColor::kRed);
+    {
+        auto probe = m_loopProfiler.Probe(kSolenoids);
+
+        if (shooterHigh) {
+            SetShooterAngle(ShooterAngle::kHigh);
+        }
+
+        if (shooterLow) {
+            SetShooterAngle(ShooterAngle::kLow);
+        }
+
+        if (climbArmsUp) {
+            // Climbing arms up
+            m_climbArms.Set(true);
+        }
+
+        if (climbArmsDown) {
+            // Climbing arms down
+            m_climbArms.Set(false);
+        }
+
+        if (gyroEnable) {
+            m_isGyroEnabled = true;
+            SetUnderglowColor(UnderglowColor::kBlue);
+        }
+
+        if (gyroDisable) {
+            m_isGyroEnabled = false;
+            SetUnderglowColor(UnderglowColor::kRed);
+        }
     }
 
-    // If in lower half, go half speed
-    double joyTwist = m_driveStick.GetTwist();
-    if (ScaleZ(m_driveStick) < 0.5) {
-        joyTwist /= 2.0;
+    {
+        auto probe = m_loopProfiler.Probe(kDrive);
+
+        if (gyroReset) {
+            m_poseEstimator.ResetHeading();
+        }
+
+        // If in lower half, go half speed
+        if (driveScale < 0.5) {
+            joyTwist /= 2.0;
+        }
+
+        if (m_isGyroEnabled) {
+            Drive(driveX, driveY, joyTwist, m_gyro.GetAngle());
+        } else {
+            Drive(driveX, driveY, joyTwist);
+        }
     }
+}
 
-    if (m_isGyroEnabled) {
-        m_drive.DriveCartesian(m_driveStick.GetX(), m_driveStick.GetY(),
-                               joyTwist, m_gyro.GetAngle());
-    } else {
-        m_drive.DriveCartesian(m_driveStick.GetX(), m_driveStick.GetY(),
-                               joyTwist);
+void Robot::DisabledInit() {
+    m_autonChooser.EndAutonomous();
+    m_shooter.Disable();
+    m_gyroCalibrator.StartBackgroundCalibration();
+}
+
+void Robot::DisabledPeriodic() {
+    // The drive is off while disabled, so the wheels only turn if the robot
+    // is pushed
+    bool stationary = true;
+    for (const auto* encoder :
+         {&m_flEncoder, &m_frEncoder, &m_rlEncoder, &m_rrEncoder}) {
+        stationary &= std::abs(encoder->GetRate()) < kStationaryWheelSpeed;
     }
+    m_gyroCalibrator.UpdateBackgroundCalibration(stationary);
+}
+
+void Robot::TestInit() {
+    m_autonChooser.EndAutonomous();
+    m_characterizationSaved = false;
+    m_shooter.StartCharacterization();
 }
 
-void Robot::DisabledInit() { m_shooter.Disable(); }
+void Robot::TestPeriodic() {
+    if (!m_characterizationSaved && !m_shooter.IsCharacterizing()) {
+        wpi::SmallString<64> path;
+        frc::filesystem::GetOperatingDirectory(path);
+        wpi::sys::path::append(path, "flywheel-characterization.bin");
+        m_shooter.SaveCharacterization(path.str());
+        m_characterizationSaved = true;
+    }
+}
 
 void Robot::SetShooterAngle(ShooterAngle angle) {
     if (angle == ShooterAngle::kHigh) {
@@ -123,6 +353,162 @@ void Robot::SetUnderglowColor(UnderglowColor color) {
     }
 }
 
+void Robot::SetDriveMode(DriveMode mode) {
+    if (mode != m_driveMode) {
+        m_driveController.Reset();
+        m_driveMode = mode;
+    }
+}
+
+void Robot::Drive(double ySpeed, double xSpeed, double zRotation,
+                  double gyroAngle) {
+    if (m_driveMode == DriveMode::kOpenLoop) {
+        m_drive.DriveCartesian(ySpeed, xSpeed, zRotation, gyroAngle);
+        return;
+    }
+
+    DriveWheelVelocities(MecanumVelocityController::CartesianToWheelSpeeds(
+        ySpeed, xSpeed, zRotation, gyroAngle));
+}
+
+void Robot::DriveWheelVelocities(
+    const MecanumVelocityController::WheelVector& references) {
+    // Stop the motors like the open-loop drive does. Braking voltages would
+    // stay applied after callers stop driving.
+    if (references.isZero()) {
+        m_driveController.Reset();
+        m_drive.DriveCartesian(0.0, 0.0, 0.0);
+        return;
+    }
+
+    if (m_driveMode == DriveMode::kOpenLoop) {
+        // The duty cycles DriveCartesian() would command for these wheel
+        // speeds, scaled for the bus voltage like m_drive's are
+        MecanumVelocityController::WheelVector dutyCycles =
+            references / MecanumVelocityController::kMaxSpeed.to<double>() *
+            m_busVoltage.GetCompensationScale();
+
+        // Like MecanumDrive, invert the right side
+        m_flMotor.Set(dutyCycles(0));
+        m_frMotor.Set(dutyCycles(1));
+        m_rlMotor.Set(-dutyCycles(2));
+        m_rrMotor.Set(-dutyCycles(3));
+        m_drive.Feed();
+        return;
+    }
+
+    // m_drive takes its motors and encoders in front-left, rear-left,
+    // front-right, rear-right order, which the controller's wheels follow
+    MecanumVelocityController::WheelVector velocities;
+    velocities << GetWheelVelocity(m_flEncoder), GetWheelVelocity(m_frEncoder),
+        GetWheelVelocity(m_rlEncoder), GetWheelVelocity(m_rrEncoder);
+
+    auto voltages = m_driveController.Update(references, velocities);
+
+    // Like MecanumDrive, invert the right side
+    m_busVoltage.SetVoltage(m_flMotor, units::volt_t{voltages(0)});
+    m_busVoltage.SetVoltage(m_frMotor, units::volt_t{voltages(1)});
+    m_busVoltage.SetVoltage(m_rlMotor, units::volt_t{-voltages(2)});
+    m_busVoltage.SetVoltage(m_rrMotor, units::volt_t{-voltages(3)});
+
+    // The motors were set directly, so keep MecanumDrive's motor safety from
+    // stopping them
+    m_drive.Feed();
+}
+
+frc3512::AutonomousChooser& Robot::GetAutonomousChooser() {
+    return m_autonChooser;
+}
+
+Shooter& Robot::GetShooter() { return m_shooter; }
+
+const Feeder& Robot::GetFeeder() const { return m_feeder; }
+
+frc::Pose2d Robot::GetEstimatedPose() const {
+    return m_poseEstimator.GetPose();
+}
+
+MecanumDriveSim& Robot::GetDriveSim() { return m_driveSim; }
+
+void Robot::SetSimulatedBattery(units::volt_t voltage,
+                                units::ohm_t resistance) {
+    m_simBatteryVoltage = voltage;
+    m_simBatteryResistance = resistance;
+}
+
+frc3512::InputRecord Robot::GetInputs() const {
+    auto& ds = frc::DriverStation::GetInstance();
+
+    frc3512::InputRecord record;
+    record.driveX = GetLoggedAxis(m_driveStick, kXAxis);
+    record.driveY = GetLoggedAxis(m_driveStick, kYAxis);
+    record.driveZ = GetLoggedAxis(m_driveStick, kZAxis);
+    record.shootX = GetLoggedAxis(m_shootStick, kXAxis);
+    record.shootY = GetLoggedAxis(m_shootStick, kYAxis);
+    record.shootZ = GetLoggedAxis(m_shootStick, kZAxis);
+    record.driveButtons =
+        static_cast<uint32_t>(ds.GetStickButtons(m_driveStick.GetPort()));
+    record.shootButtons =
+        static_cast<uint32_t>(ds.GetStickButtons(m_shootStick.GetPort()));
+    record.flCount = m_flEncoder.Get();
+    record.rlCount = m_rlEncoder.Get();
+    record.frCount = m_frEncoder.Get();
+    record.rrCount = m_rrEncoder.Get();
+    record.flRate = static_cast<float>(m_flEncoder.GetRate());
+    record.rlRate = static_cast<float>(m_rlEncoder.GetRate());
+    record.frRate = static_cast<float>(m_frEncoder.GetRate());
+    record.rrRate = static_cast<float>(m_rrEncoder.GetRate());
+    record.gyroAngle = static_cast<float>(m_gyro.GetAngle());
+    record.batteryVoltage =
+        static_cast<float>(frc::RobotController::GetInputVoltage());
+    record.enabled = IsEnabled();
+    record.autonomous = IsAutonomous();
+    record.test = IsTest();
+    return record;
+}
+
+frc3512::OutputRecord Robot::GetOutputs() const {
+    frc3512::OutputRecord record;
+    record.flOutput = static_cast<float>(m_flMotor.Get());
+    record.rlOutput = static_cast<float>(m_rlMotor.Get());
+    record.frOutput = static_cast<float>(m_frMotor.Get());
+    record.rrOutput = static_cast<float>(m_rrMotor.Get());
+    record.shooterOutput = static_cast<float>(m_shooter.GetMotorOutput());
+    record.shooterAngle = m_shooterAngle.Get();
+    record.climbArms = m_climbArms.Get();
+    record.feedExtended = m_feeder.IsFeedExtended();
+    record.guardLowered = m_feeder.IsGuardLowered();
+    record.underglow = static_cast<uint8_t>(m_underGlow.Get());
+    return record;
+}
+
+void Robot::SetSimulatedInputs(const frc3512::InputRecord& inputs) {
+    SetSimulatedStick(m_driveStick, inputs.driveX, inputs.driveY,
+                      inputs.driveZ, inputs.driveButtons);
+    SetSimulatedStick(m_shootStick, inputs.shootX, inputs.shootY,
+                      inputs.shootZ, inputs.shootButtons);
+
+    frc::sim::EncoderSim{m_flEncoder}.SetCount(inputs.flCount);
+    frc::sim::EncoderSim{m_rlEncoder}.SetCount(inputs.rlCount);
+    frc::sim::EncoderSim{m_frEncoder}.SetCount(inputs.frCount);
+    frc::sim::EncoderSim{m_rrEncoder}.SetCount(inputs.rrCount);
+    frc::sim::EncoderSim{m_flEncoder}.SetRate(inputs.flRate);
+    frc::sim::EncoderSim{m_rlEncoder}.SetRate(inputs.rlRate);
+    frc::sim::EncoderSim{m_frEncoder}.SetRate(inputs.frRate);
+    frc::sim::EncoderSim{m_rrEncoder}.SetRate(inputs.rrRate);
+    frc::sim::AnalogGyroSim{m_gyro}.SetAngle(inputs.gyroAngle);
+    frc::sim::RoboRioSim::SetVInVoltage(units::volt_t{inputs.batteryVoltage});
+
+    frc::sim::DriverStationSim::SetEnabled(inputs.enabled);
+    frc::sim::DriverStationSim::SetAutonomous(inputs.autonomous);
+    frc::sim::DriverStationSim::SetTest(inputs.test);
+    frc::sim::DriverStationSim::NotifyNewData();
+}
+
+void Robot::SetSimulatedPhysicsEnabled(bool enabled) {
+    m_simPhysicsEnabled = enabled;
+}
+
 #ifndef RUNNING_FRC_TESTS
 int main() { return frc::StartRobot<Robot>(); }
 #endif
@@ -0,0 +1,134 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <fmt/compile.h>
+#include <frc2/Timer.h>
+#include <units/time.h>
+
+#include "Robot.hpp"
+#include "telemetry/ConsoleLog.hpp"
+
+namespace {
+
+// Maximum time FollowTrajectory() spends correcting toward the final pose after
+// the trajectory ends
+constexpr units::second_t kSettleTimeout = 0.5_s;
+
+/**
+ * Records how long an autonomous primitive ran and how many cycles it yielded
+ * for, and prints them when the primitive returns.
+ */
+class PrimitiveTiming {
+public:
+    explicit PrimitiveTiming(const char* name)
+        : m_name{name}, m_startTime{frc2::Timer::GetFPGATimestamp()} {}
+
+    ~PrimitiveTiming() {
+        auto duration = frc2::Timer::GetFPGATimestamp() - m_startTime;
+        frc3512::Log(FMT_COMPILE("{}: {:.3f} s, {} cycles\n"), m_name,
+                     duration.to<double>(), m_cycles);
+    }
+
+    /**
+     * Counts a cycle the primitive yielded for.
+     */
+    void AddCycle() { ++m_cycles; }
+
+private:
+    const char* m_name;
+    units::second_t m_startTime;
+    int m_cycles = 0;
+};
+
+}  // namespace
+
+bool Robot::FollowTrajectory(const char* name) {
+    PrimitiveTiming timing{"FollowTrajectory"};
+
+    auto trajectory = m_trajectories.Get(name);
+    if (!trajectory) {
+        frc3512::LogError(FMT_COMPILE("FollowTrajectory: no trajectory {}\n"),
+                          name);
+        return true;
+    }
+
+    frc2::Timer timer;
+    timer.Start();
+
+    bool finished = m_autonChooser.AwaitUntil([&] {
+        // Past the end, the last sample holds the final pose
+        auto time = timer.Get();
+        auto references = m_trajectoryController.Calculate(
+            m_poseEstimator.GetPose(), trajectory->Sample(time));
+        if (time >= trajectory->GetTotalTime() &&
+            (m_trajectoryController.AtReference() ||
+             time >= trajectory->GetTotalTime() + kSettleTimeout)) {
+            return true;
+        }
+
+        DriveWheelVelocities(references);
+        timing.AddCycle();
+        return false;
+    });
+
+    Drive(0.0, 0.0, 0.0, 0.0);
+    return finished;
+}
+
+bool Robot::WaitFor(units::second_t duration) {
+    PrimitiveTiming timing{"WaitFor"};
+
+    frc2::Timer timer;
+    timer.Start();
+
+    return m_autonChooser.AwaitUntil([&] {
+        if (timer.Get() >= duration) {
+            return true;
+        }
+
+        timing.AddCycle();
+        return false;
+    });
+}
+
+bool Robot::WaitForShooter(units::second_t timeout) {
+    PrimitiveTiming timing{"WaitForShooter"};
+
+    frc2::Timer timer;
+    timer.Start();
+
+    return m_autonChooser.AwaitUntil([&] {
+        if (m_shooter.AtReference() || timer.Get() >= timeout) {
+            return true;
+        }
+
+        timing.AddCycle();
+        return false;
+    });
+}
+
+bool Robot::FeedDiscs(unsigned int count, units::second_t interval) {
+    PrimitiveTiming timing{"FeedDiscs"};
+
+    frc2::Timer timer;
+    timer.Start();
+    unsigned int fed = 0;
+
+    return m_autonChooser.AwaitUntil([&] {
+        if (fed == count) {
+            return true;
+        }
+
+        // WaitForShooter() also returns when it times out, so the first
+        // frisbee only skips the interval if the shooter is up to speed
+        if (((fed == 0 && m_shooter.AtReference()) ||
+             timer.Get() > interval) &&
+            !m_feeder.IsFeeding()) {
+            m_feeder.Activate();
+            ++fed;
+            timer.Reset();
+        }
+
+        timing.AddCycle();
+        return false;
+    });
+}
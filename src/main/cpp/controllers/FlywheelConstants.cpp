@@ -0,0 +1,47 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "controllers/FlywheelConstants.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include <fmt/compile.h>
+#include <wpi/json.h>
+
+#include "telemetry/ConsoleLog.hpp"
+
+FlywheelConstants FlywheelConstants::Load(const std::string& path) {
+    FlywheelConstants constants;
+
+    std::ifstream file{path};
+    if (!file) {
+        frc3512::LogError(
+            FMT_COMPILE("FlywheelConstants: {} not found; using defaults\n"),
+            path);
+        return constants;
+    }
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    try {
+        auto json = wpi::json::parse(contents.str());
+        if (json.count("kS")) {
+            constants.kS = units::volt_t{json.at("kS").get<double>()};
+        }
+        if (json.count("kV")) {
+            constants.kV = json.at("kV").get<double>() * 1_V / 1_rad_per_s;
+        }
+        if (json.count("kA")) {
+            constants.kA =
+                json.at("kA").get<double>() * 1_V / 1_rad_per_s_sq;
+        }
+    } catch (const wpi::json::exception& e) {
+        frc3512::LogError(
+            FMT_COMPILE("FlywheelConstants: {}: {}; using defaults\n"), path,
+            e.what());
+        return FlywheelConstants{};
+    }
+
+    return constants;
+}
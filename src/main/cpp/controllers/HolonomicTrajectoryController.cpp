@@ -0,0 +1,79 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "controllers/HolonomicTrajectoryController.hpp"
+
+#include <cmath>
+
+#include <units/math.h>
+
+#include "MecanumPoseEstimator.hpp"
+
+namespace {
+
+// Distance from the robot's center to each wheel along X plus along Y, which
+// scales the angular velocity's share of every wheel's speed
+constexpr double kWheelLever =
+    units::meter_t{MecanumPoseEstimator::kWheelBase / 2 +
+                   MecanumPoseEstimator::kTrackWidth / 2}
+        .to<double>();
+
+// Maps the robot-relative forward velocity, left velocity, and
+// counterclockwise angular velocity to the wheels, like
+// frc::MecanumDriveKinematics::ToWheelSpeeds()
+const Eigen::Matrix<double, 4, 3> kInverseKinematics = [] {
+    Eigen::Matrix<double, 4, 3> kinematics;
+    kinematics.row(0) << 1.0, -1.0, -kWheelLever;  // Front-left
+    kinematics.row(1) << 1.0, 1.0, -kWheelLever;   // Rear-left
+    kinematics.row(2) << 1.0, 1.0, kWheelLever;    // Front-right
+    kinematics.row(3) << 1.0, -1.0, kWheelLever;   // Rear-right
+    return kinematics;
+}();
+
+}  // namespace
+
+HolonomicTrajectoryController::WheelVector
+HolonomicTrajectoryController::Calculate(
+    const frc::Pose2d& pose, const frc3512::TrajectorySample& reference) {
+    units::meter_t xError = units::meter_t{reference.x} - pose.X();
+    units::meter_t yError = units::meter_t{reference.y} - pose.Y();
+
+    // Rotation2d's difference wraps the error to the shortest direction
+    units::radian_t headingError =
+        (frc::Rotation2d{units::radian_t{reference.heading}} - pose.Rotation())
+            .Radians();
+
+    m_atReference =
+        units::math::hypot(xError, yError) < kPositionTolerance &&
+        units::math::abs(headingError) < kHeadingTolerance;
+
+    units::meters_per_second_t vx =
+        units::meters_per_second_t{reference.vx} + kTranslationGain * xError;
+    units::meters_per_second_t vy =
+        units::meters_per_second_t{reference.vy} + kTranslationGain * yError;
+    units::radians_per_second_t omega =
+        units::radians_per_second_t{reference.omega} +
+        kRotationGain * headingError;
+
+    // Rotate the field velocity into the robot's frame
+    double cos = pose.Rotation().Cos();
+    double sin = pose.Rotation().Sin();
+    Eigen::Vector3d chassisSpeeds{
+        vx.to<double>() * cos + vy.to<double>() * sin,
+        -vx.to<double>() * sin + vy.to<double>() * cos, omega.to<double>()};
+
+    WheelVector speeds = kInverseKinematics * chassisSpeeds;
+
+    // Scale every wheel down together if any is over the limit so the robot
+    // keeps its direction of travel
+    double maxSpeed = MecanumVelocityController::kMaxSpeed.to<double>();
+    double maxMagnitude = speeds.cwiseAbs().maxCoeff();
+    if (maxMagnitude > maxSpeed) {
+        speeds *= maxSpeed / maxMagnitude;
+    }
+
+    return speeds;
+}
+
+bool HolonomicTrajectoryController::AtReference() const {
+    return m_atReference;
+}
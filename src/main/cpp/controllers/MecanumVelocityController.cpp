@@ -0,0 +1,79 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "controllers/MecanumVelocityController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <units/angle.h>
+
+namespace {
+
+// Maps the field-corrected right, forward, and clockwise rotation commands to
+// the wheels the same way MecanumDrive does
+const Eigen::Matrix<double, 4, 3> kMix = [] {
+    Eigen::Matrix<double, 4, 3> mix;
+    mix.row(0) << 1.0, 1.0, 1.0;    // Front-left
+    mix.row(1) << -1.0, 1.0, 1.0;   // Rear-left
+    mix.row(2) << -1.0, 1.0, -1.0;  // Front-right
+    mix.row(3) << 1.0, 1.0, -1.0;   // Rear-right
+    return mix;
+}();
+
+double ApplyDeadband(double value, double deadband) {
+    if (std::abs(value) <= deadband) {
+        return 0.0;
+    }
+    return (value - std::copysign(deadband, value)) / (1.0 - deadband);
+}
+
+}  // namespace
+
+MecanumVelocityController::MecanumVelocityController(units::second_t dt)
+    : m_dt{dt} {}
+
+MecanumVelocityController::WheelVector
+MecanumVelocityController::CartesianToWheelSpeeds(double ySpeed, double xSpeed,
+                                                  double zRotation,
+                                                  double gyroAngle) {
+    ySpeed = ApplyDeadband(std::clamp(ySpeed, -1.0, 1.0), kDeadband);
+    xSpeed = ApplyDeadband(std::clamp(xSpeed, -1.0, 1.0), kDeadband);
+
+    // Rotate the command from the field frame into the robot's
+    double angle = units::radian_t{units::degree_t{-gyroAngle}}.to<double>();
+    double cos = std::cos(angle);
+    double sin = std::sin(angle);
+    Eigen::Vector3d command{ySpeed * cos - xSpeed * sin,
+                            ySpeed * sin + xSpeed * cos, zRotation};
+
+    WheelVector speeds = kMix * command;
+
+    // Scale every wheel down together if any is over full speed
+    double maxMagnitude = speeds.cwiseAbs().maxCoeff();
+    if (maxMagnitude > 1.0) {
+        speeds /= maxMagnitude;
+    }
+
+    return speeds * kMaxSpeed.to<double>();
+}
+
+void MecanumVelocityController::Reset() { m_lastReferences.setZero(); }
+
+MecanumVelocityController::WheelVector MecanumVelocityController::Update(
+    const WheelVector& references, const WheelVector& velocities) {
+    WheelVector accelerations =
+        (references - m_lastReferences) / m_dt.to<double>();
+    m_lastReferences = references;
+
+    WheelVector voltages = kV.to<double>() * references +
+                           kA.to<double>() * accelerations +
+                           kP.to<double>() * (references - velocities);
+
+    // Scale every wheel down together if any is over the limit
+    double maxMagnitude = voltages.cwiseAbs().maxCoeff();
+    if (maxMagnitude > kMaxVoltage.to<double>()) {
+        voltages *= kMaxVoltage.to<double>() / maxMagnitude;
+    }
+
+    return voltages;
+}
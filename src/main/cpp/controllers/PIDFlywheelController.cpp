@@ -0,0 +1,38 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "controllers/PIDFlywheelController.hpp"
+
+#include <wpi/MathExtras.h>
+
+PIDFlywheelController::PIDFlywheelController(
+    const FlywheelConstants& constants, units::second_t dt)
+    : m_constants{constants}, m_controller{0.0015, 0.000096, 0.0, dt} {
+    m_controller.SetTolerance(100.0);
+}
+
+void PIDFlywheelController::SetReference(
+    units::revolutions_per_minute_t angularVelocity) {
+    m_controller.SetSetpoint(angularVelocity.to<double>());
+}
+
+bool PIDFlywheelController::AtReference() const { return m_atReference; }
+
+void PIDFlywheelController::Reset(units::revolutions_per_minute_t) {
+    m_controller.Reset();
+    m_atReference = false;
+}
+
+units::volt_t PIDFlywheelController::Update(
+    units::revolutions_per_minute_t angularVelocity) {
+    units::revolutions_per_minute_t reference{m_controller.GetSetpoint()};
+    units::volt_t feedforward =
+        m_constants.kS * wpi::sgn(reference.to<double>()) +
+        m_constants.kV * reference;
+    double output = m_controller.Calculate(angularVelocity.to<double>());
+
+    // The PID controller reports being at its setpoint before it has computed
+    // an error, so this is only updated after Calculate()
+    m_atReference = m_controller.AtSetpoint();
+
+    return output * kNominalVoltage + feedforward;
+}
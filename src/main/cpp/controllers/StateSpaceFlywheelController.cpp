@@ -0,0 +1,66 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "controllers/StateSpaceFlywheelController.hpp"
+
+#include <algorithm>
+
+#include <frc/StateSpaceUtil.h>
+#include <frc/system/plant/LinearSystemId.h>
+#include <units/angle.h>
+#include <units/math.h>
+#include <wpi/MathExtras.h>
+
+StateSpaceFlywheelController::StateSpaceFlywheelController(
+    const FlywheelConstants& constants, units::second_t dt)
+    : m_dt{dt},
+      m_kS{constants.kS},
+      m_plant{frc::LinearSystemId::IdentifyVelocitySystem<units::radian>(
+          constants.kV, constants.kA)},
+      m_observer{m_plant,
+                 {kModelStdDev.to<double>()},
+                 {kMeasurementStdDev.to<double>()},
+                 dt},
+      m_lqr{m_plant,
+            {units::radians_per_second_t{kVelocityTolerance}.to<double>()},
+            {kMaxVoltage.to<double>()},
+            dt},
+      m_loop{m_plant, m_lqr, m_observer, kMaxVoltage, dt} {}
+
+void StateSpaceFlywheelController::SetReference(
+    units::revolutions_per_minute_t angularVelocity) {
+    m_reference = angularVelocity;
+}
+
+bool StateSpaceFlywheelController::AtReference() const {
+    return m_atReference;
+}
+
+void StateSpaceFlywheelController::Reset(
+    units::revolutions_per_minute_t angularVelocity) {
+    m_loop.Reset(frc::MakeMatrix<1, 1>(
+        units::radians_per_second_t{angularVelocity}.to<double>()));
+    m_atReference = false;
+}
+
+units::volt_t StateSpaceFlywheelController::Update(
+    units::revolutions_per_minute_t angularVelocity) {
+    m_loop.SetNextR(frc::MakeMatrix<1, 1>(m_reference.to<double>()));
+    m_loop.Correct(frc::MakeMatrix<1, 1>(
+        units::radians_per_second_t{angularVelocity}.to<double>()));
+    m_loop.Predict(m_dt);
+
+    m_atReference =
+        units::math::abs(m_reference - GetEstimatedAngularVelocity()) <
+        kVelocityTolerance;
+
+    // The model doesn't include static friction, so it's compensated for
+    // separately
+    units::volt_t voltage =
+        units::volt_t{m_loop.U(0)} + m_kS * wpi::sgn(m_reference.to<double>());
+    return std::clamp(voltage, -kMaxVoltage, kMaxVoltage);
+}
+
+units::revolutions_per_minute_t
+StateSpaceFlywheelController::GetEstimatedAngularVelocity() const {
+    return units::radians_per_second_t{m_loop.Xhat(0)};
+}
@@ -0,0 +1,17 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "simulation/GeartoothEncoderSim.hpp"
+
+#include <frc/simulation/SimDeviceSim.h>
+
+GeartoothEncoderSim::GeartoothEncoderSim(const GeartoothEncoder& encoder) {
+    frc::sim::SimDeviceSim deviceSim{"GeartoothEncoder", encoder.GetChannel()};
+    m_simRate = deviceSim.GetDouble("rate");
+}
+
+void GeartoothEncoderSim::SetRate(
+    units::revolutions_per_minute_t angularVelocity) {
+    if (m_simRate) {
+        m_simRate.Set(angularVelocity.to<double>());
+    }
+}
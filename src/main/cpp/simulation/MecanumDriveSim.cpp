@@ -0,0 +1,119 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "simulation/MecanumDriveSim.hpp"
+
+#include <frc/RobotController.h>
+#include <frc/system/plant/LinearSystemId.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/math.h>
+
+namespace {
+
+frc::LinearSystem<1, 1, 1> MakeWheelPlant() {
+    return frc::LinearSystemId::IdentifyVelocitySystem<units::meter>(
+        MecanumDriveSim::kV, MecanumDriveSim::kA);
+}
+
+}  // namespace
+
+MecanumDriveSim::MecanumDriveSim(
+    frc::SpeedController& frontLeftMotor, frc::SpeedController& rearLeftMotor,
+    frc::SpeedController& frontRightMotor, frc::SpeedController& rearRightMotor,
+    const frc::Encoder& frontLeftEncoder, const frc::Encoder& rearLeftEncoder,
+    const frc::Encoder& frontRightEncoder, const frc::Encoder& rearRightEncoder,
+    const frc::AnalogGyro& gyro)
+    : m_motors{&frontLeftMotor, &rearLeftMotor, &frontRightMotor,
+               &rearRightMotor},
+      m_encoderSims{frc::sim::EncoderSim{frontLeftEncoder},
+                    frc::sim::EncoderSim{rearLeftEncoder},
+                    frc::sim::EncoderSim{frontRightEncoder},
+                    frc::sim::EncoderSim{rearRightEncoder}},
+      m_gyroSim{gyro},
+      m_wheelSims{frc::sim::LinearSystemSim<1, 1, 1>{MakeWheelPlant()},
+                  frc::sim::LinearSystemSim<1, 1, 1>{MakeWheelPlant()},
+                  frc::sim::LinearSystemSim<1, 1, 1>{MakeWheelPlant()},
+                  frc::sim::LinearSystemSim<1, 1, 1>{MakeWheelPlant()}},
+      m_kinematics{{kWheelBase / 2, kTrackWidth / 2},
+                   {kWheelBase / 2, -kTrackWidth / 2},
+                   {-kWheelBase / 2, kTrackWidth / 2},
+                   {-kWheelBase / 2, -kTrackWidth / 2}} {
+    for (int i = 0; i < kWheels; ++i) {
+        m_distances[i] = 0_in;
+        m_lastCounts[i] = m_encoderSims[i].GetCount();
+    }
+}
+
+void MecanumDriveSim::Update(units::second_t dt) {
+    units::volt_t batteryVoltage{frc::RobotController::GetInputVoltage()};
+
+    std::array<units::meters_per_second_t, kWheels> speeds;
+    m_currentDraw = 0_A;
+    for (int i = 0; i < kWheels; ++i) {
+        // MecanumDrive inverts the right side (indices 2 and 3)
+        double sign = i < 2 ? 1.0 : -1.0;
+        units::volt_t voltage = sign * m_motors[i]->Get() * batteryVoltage;
+
+        m_wheelSims[i].SetInput(0, voltage.to<double>());
+        m_wheelSims[i].Update(dt);
+        speeds[i] = units::meters_per_second_t{m_wheelSims[i].GetOutput(0)};
+
+        units::radians_per_second_t motorSpeed{
+            speeds[i].to<double>() / units::meter_t{kWheelRadius}.to<double>() *
+            kGearing};
+        m_currentDraw +=
+            units::math::abs(m_motor.Current(motorSpeed, voltage));
+
+        // Continue from the encoder's value if robot code reset it
+        auto& encoderSim = m_encoderSims[i];
+        if (encoderSim.GetCount() != m_lastCounts[i]) {
+            m_distances[i] = units::inch_t{encoderSim.GetDistance()};
+        }
+        m_distances[i] += speeds[i] * dt;
+        encoderSim.SetDistance(m_distances[i].to<double>() +
+                               SampleNoise(m_encoderStdDev.to<double>()));
+        encoderSim.SetRate(units::inch_t{speeds[i] * 1_s}.to<double>());
+        m_lastCounts[i] = encoderSim.GetCount();
+    }
+
+    auto chassisSpeeds = m_kinematics.ToChassisSpeeds(
+        {speeds[0], speeds[2], speeds[1], speeds[3]});
+
+    double traction = 1.0 - m_slip;
+    m_pose = m_pose.Exp({chassisSpeeds.vx * traction * dt,
+                         chassisSpeeds.vy * traction * dt,
+                         chassisSpeeds.omega * traction * dt});
+
+    // The gyro's angle is clockwise positive
+    units::degrees_per_second_t rate =
+        -chassisSpeeds.omega * traction +
+        units::degrees_per_second_t{
+            SampleNoise(m_gyroRateStdDev.to<double>())};
+    m_gyroSim.SetAngle(m_gyroSim.GetAngle() +
+                       units::degree_t{rate * dt}.to<double>());
+    m_gyroSim.SetRate(rate.to<double>());
+}
+
+units::ampere_t MecanumDriveSim::GetCurrentDraw() const {
+    return m_currentDraw;
+}
+
+frc::Pose2d MecanumDriveSim::GetPose() const { return m_pose; }
+
+void MecanumDriveSim::SetWheelSlip(double slip) { m_slip = slip; }
+
+void MecanumDriveSim::SetMeasurementNoise(
+    units::inch_t encoderStdDev, units::degrees_per_second_t gyroRateStdDev,
+    uint32_t seed) {
+    m_generator.seed(seed);
+    m_noise.reset();
+    m_encoderStdDev = encoderStdDev;
+    m_gyroRateStdDev = gyroRateStdDev;
+}
+
+double MecanumDriveSim::SampleNoise(double stdDev) {
+    if (stdDev == 0.0) {
+        return 0.0;
+    }
+    return stdDev * m_noise(m_generator);
+}
@@ -1,7 +1,10 @@
-// Copyright (c) 2013-2020 FRC Team 3512. All Rights Reserved.
+// Copyright (c) 2013-2021 FRC Team 3512. All Rights Reserved.
 
 #include "subsystems/Feeder.hpp"
 
+Feeder::Feeder(frc3512::TelemetryLogger& telemetry)
+    : m_telemetry{telemetry.AddChannel<frc3512::FeederRecord>()} {}
+
 void Feeder::Activate() {
     // Start process if it's stopped
     if (!m_isActivated) {
@@ -28,6 +31,12 @@ void Feeder::Activate() {
 
 bool Feeder::IsFeeding() { return m_isActivated; }
 
+unsigned int Feeder::GetTotalShot() const { return m_lifetimeShot; }
+
+bool Feeder::IsFeedExtended() const { return m_frisbeeFeed.Get(); }
+
+bool Feeder::IsGuardLowered() const { return m_frisbeeGuard.Get(); }
+
 void Feeder::Update() {
     // If frisbee is going to be fed into the shooter
     if (m_isActivated) {
@@ -40,6 +49,7 @@ void Feeder::Update() {
                 // If feed actuator is now in default position
                 if (m_frisbeeFeed.Get() == false) {
                     m_numShot++;
+                    m_lifetimeShot++;
                 }
             }
         }
@@ -61,4 +71,13 @@ void Feeder::Update() {
             m_isActivated = false;
         }
     }
+
+    frc3512::FeederRecord record;
+    record.numShot = m_numShot;
+    record.totalToShoot = m_totalToShoot;
+    record.lifetimeShot = m_lifetimeShot;
+    record.activated = m_isActivated;
+    record.feedExtended = IsFeedExtended();
+    record.guardLowered = IsGuardLowered();
+    m_telemetry.Log(record);
 }
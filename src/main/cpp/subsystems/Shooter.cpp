@@ -1,37 +1,280 @@
-// Copyright (c) 2013-2020 FRC Team 3512. All Rights Reserved.
+// Copyright (c) 2013-2021 FRC Team 3512. All Rights Reserved.
 
 #include "subsystems/Shooter.hpp"
 
-Shooter::Shooter() {
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#include <fmt/compile.h>
+#include <frc/Filesystem.h>
+#include <frc/RobotBase.h>
+#include <frc/system/plant/DCMotor.h>
+#include <frc/system/plant/LinearSystemId.h>
+#include <frc2/Timer.h>
+#include <units/angle.h>
+#include <wpi/Path.h>
+#include <wpi/SmallString.h>
+
+#include "telemetry/ConsoleLog.hpp"
+
+namespace {
+
+// One segment of the characterization script. The voltage starts at
+// startVoltage and changes at rampRate for the segment's duration.
+struct CharacterizationStep {
+    units::second_t duration;
+    units::volt_t startVoltage;
+    decltype(1_V / 1_s) rampRate;
+};
+
+// A quasistatic ramp identifies kS and kV, and the steps excite the
+// acceleration term for kA. The coasting segments let the flywheel spin down
+// between tests.
+constexpr std::array<CharacterizationStep, 6> kCharacterizationScript{
+    {{12_s, 0_V, 0.75_V / 1_s},
+     {4_s, 0_V, 0_V / 1_s},
+     {4_s, 6_V, 0_V / 1_s},
+     {4_s, 0_V, 0_V / 1_s},
+     {4_s, 10_V, 0_V / 1_s},
+     {4_s, 0_V, 0_V / 1_s}}};
+
+constexpr units::second_t kCharacterizationDuration =
+    12_s + 4_s + 4_s + 4_s + 4_s + 4_s;
+
+FlywheelConstants LoadConstants() {
+    wpi::SmallString<64> path;
+    frc::filesystem::GetDeployDirectory(path);
+    wpi::sys::path::append(path, "flywheel.json");
+    return FlywheelConstants::Load(path.str());
+}
+
+}  // namespace
+
+Shooter::Shooter(const frc3512::BusVoltage& busVoltage,
+                 frc3512::TelemetryLogger& telemetry,
+                 units::second_t controllerPeriod)
+    : m_busVoltage{busVoltage},
+      m_telemetry{telemetry.AddChannel<frc3512::ShooterRecord>()},
+      m_constants{LoadConstants()},
+      m_pidController{m_constants, controllerPeriod},
+      m_stateSpaceController{m_constants, controllerPeriod},
+      m_controllerPeriod{controllerPeriod},
+      m_flywheelSim{frc::LinearSystemId::IdentifyVelocitySystem<units::radian>(
+                        m_constants.kV, m_constants.kA),
+                    frc::DCMotor::CIM(2), 1.0} {
     m_motor1.SetInverted(true);
     m_motor2.SetInverted(true);
-    m_controller.SetTolerance(100.0);
+
+    m_characterizationSamples.reserve(
+        static_cast<size_t>(kCharacterizationDuration / controllerPeriod) + 1);
+
+    m_notifier.StartPeriodic(controllerPeriod);
 }
 
-void Shooter::Enable() { m_enabled = true; }
+void Shooter::Enable() {
+    m_characterizing = false;
+    m_atReference = false;
+    m_enabled = true;
+}
 
-void Shooter::Disable() { m_enabled = false; }
+void Shooter::Disable() {
+    m_characterizing = false;
+    m_enabled = false;
+    m_atReference = false;
+}
 
 bool Shooter::IsEnabled() const { return m_enabled; }
 
+void Shooter::SetControllerType(ControllerType type) {
+    m_atReference = false;
+    m_controllerType = type;
+}
+
+Shooter::ControllerType Shooter::GetControllerType() const {
+    return m_controllerType;
+}
+
 void Shooter::SetReference(units::revolutions_per_minute_t angularVelocity) {
-    m_controller.SetSetpoint(angularVelocity.to<double>());
+    m_reference = angularVelocity.to<double>();
+}
+
+bool Shooter::AtReference() const { return m_atReference; }
+
+units::revolutions_per_minute_t Shooter::GetAngularVelocity() const {
+    return units::revolutions_per_minute_t{m_angularVelocity.load()};
+}
+
+double Shooter::GetMotorOutput() const { return m_motor1.Get(); }
+
+void Shooter::StartCharacterization() {
+    m_enabled = false;
+    m_atReference = false;
+
+    {
+        std::scoped_lock lock{m_characterizationMutex};
+        m_characterizationSamples.clear();
+    }
+
+    m_characterizing = true;
+}
+
+bool Shooter::IsCharacterizing() const { return m_characterizing; }
+
+bool Shooter::SaveCharacterization(const std::string& path) {
+    if (m_characterizing) {
+        return false;
+    }
+
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{
+        std::fopen(path.c_str(), "wb"), &std::fclose};
+    if (file == nullptr) {
+        frc3512::LogError(FMT_COMPILE("Shooter: failed to open {}\n"), path);
+        return false;
+    }
+
+    std::scoped_lock lock{m_characterizationMutex};
+
+    FlywheelCharacterizationHeader header;
+    header.sampleSize = sizeof(FlywheelCharacterizationSample);
+
+    size_t count = m_characterizationSamples.size();
+    if (std::fwrite(&header, sizeof(header), 1, file.get()) != 1 ||
+        std::fwrite(m_characterizationSamples.data(),
+                    sizeof(FlywheelCharacterizationSample), count,
+                    file.get()) != count) {
+        frc3512::LogError(FMT_COMPILE("Shooter: failed to write {}\n"), path);
+        return false;
+    }
+
+    frc3512::Log(
+        FMT_COMPILE("Shooter: wrote {} characterization samples to {}\n"),
+        count, path);
+    return true;
 }
 
-bool Shooter::AtReference() const { return m_controller.AtSetpoint(); }
+units::ampere_t Shooter::GetSimulatedCurrentDraw() const {
+    return units::ampere_t{m_simCurrentDraw.load()};
+}
+
+void Shooter::SetSimulatedMeasurementNoise(
+    units::revolutions_per_minute_t stdDev, uint32_t seed) {
+    m_simGenerator.seed(seed);
+    m_simNoise.reset();
+    m_simNoiseStdDev = stdDev;
+}
+
+void Shooter::SetSimulatedMeasurementSource(
+    std::function<units::revolutions_per_minute_t()> source) {
+    m_simMeasurementSource = std::move(source);
+}
 
 void Shooter::Update() {
-    if (m_enabled) {
-        units::revolutions_per_minute_t speed{m_encoder.GetRate()};
-        double feedforward =
-            units::revolutions_per_minute_t{m_controller.GetSetpoint()} /
-            kMaxSpeed;
-        double output =
-            m_controller.Calculate(speed.to<double>()) + feedforward;
-        m_motor1.Set(output);
-        m_motor2.Set(output);
+    if constexpr (frc::RobotBase::IsSimulation()) {
+        UpdateSimulation();
+    }
+
+    units::revolutions_per_minute_t speed{m_encoder.GetRate()};
+    m_angularVelocity = speed.to<double>();
+
+    units::volt_t voltage = 0_V;
+    if (m_characterizing) {
+        voltage = UpdateCharacterization(speed);
+        m_activeController = nullptr;
+    } else if (m_enabled) {
+        FlywheelController* controller;
+        if (m_controllerType == ControllerType::kStateSpace) {
+            controller = &m_stateSpaceController;
+        } else {
+            controller = &m_pidController;
+        }
+
+        // Start the controller from the current state if it just took over
+        if (controller != m_activeController) {
+            controller->Reset(speed);
+            m_activeController = controller;
+        }
+
+        controller->SetReference(
+            units::revolutions_per_minute_t{m_reference.load()});
+        voltage = controller->Update(speed);
+        m_busVoltage.SetVoltage(m_motor1, voltage);
+        m_busVoltage.SetVoltage(m_motor2, voltage);
+        m_atReference = controller->AtReference();
     } else {
         m_motor1.Set(0.0);
         m_motor2.Set(0.0);
+        m_atReference = false;
+        m_activeController = nullptr;
+    }
+
+    frc3512::ShooterRecord record;
+    record.reference = static_cast<float>(m_reference.load());
+    record.angularVelocity = speed.to<float>();
+    record.voltage = voltage.to<float>();
+    record.enabled = m_enabled;
+    record.atReference = m_atReference;
+    record.characterizing = m_characterizing;
+    record.controllerType = static_cast<uint8_t>(m_controllerType.load());
+    m_telemetry.Log(record);
+}
+
+units::volt_t Shooter::UpdateCharacterization(
+    units::revolutions_per_minute_t angularVelocity) {
+    std::scoped_lock lock{m_characterizationMutex};
+
+    auto now = frc2::Timer::GetFPGATimestamp();
+    if (m_characterizationSamples.empty()) {
+        m_characterizationStart = now;
+    }
+
+    // Find the script segment for the elapsed time
+    units::second_t elapsed = now - m_characterizationStart;
+    units::second_t segmentStart = 0_s;
+    const CharacterizationStep* step = nullptr;
+    for (const auto& candidate : kCharacterizationScript) {
+        if (elapsed < segmentStart + candidate.duration) {
+            step = &candidate;
+            break;
+        }
+        segmentStart += candidate.duration;
+    }
+
+    if (step == nullptr) {
+        m_busVoltage.SetVoltage(m_motor1, 0_V);
+        m_busVoltage.SetVoltage(m_motor2, 0_V);
+        m_characterizing = false;
+        return 0_V;
+    }
+
+    units::volt_t voltage =
+        step->startVoltage + step->rampRate * (elapsed - segmentStart);
+    m_busVoltage.SetVoltage(m_motor1, voltage);
+    m_busVoltage.SetVoltage(m_motor2, voltage);
+
+    m_characterizationSamples.push_back(
+        {static_cast<uint32_t>(units::microsecond_t{elapsed}.to<double>()),
+         voltage.to<float>(), angularVelocity.to<float>()});
+
+    return voltage;
+}
+
+void Shooter::UpdateSimulation() {
+    if (m_simMeasurementSource) {
+        m_encoderSim.SetRate(m_simMeasurementSource());
+        m_simCurrentDraw = 0.0;
+        return;
+    }
+
+    // Get() returns the commanded output before inversion
+    m_flywheelSim.SetInputVoltage(m_motor1.Get() * m_busVoltage.Get());
+    m_flywheelSim.Update(m_controllerPeriod);
+
+    units::revolutions_per_minute_t rate = m_flywheelSim.GetAngularVelocity();
+    if (m_simNoiseStdDev != 0_rpm) {
+        rate += m_simNoiseStdDev * m_simNoise(m_simGenerator);
     }
+    m_encoderSim.SetRate(rate);
+    m_simCurrentDraw = m_flywheelSim.GetCurrentDraw().to<double>();
 }
@@ -0,0 +1,108 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "telemetry/ConsoleLog.hpp"
+
+#include <cstdio>
+#include <mutex>
+
+#include <fmt/core.h>
+
+#include "RealTime.hpp"
+
+using namespace frc3512;
+
+ConsoleLogger& ConsoleLogger::GetInstance() {
+    static ConsoleLogger logger;
+    return logger;
+}
+
+ConsoleLogger::ConsoleLogger() {
+    m_thread = std::thread{[=] {
+        SetCurrentThreadBackground();
+        Run();
+    }};
+}
+
+ConsoleLogger::~ConsoleLogger() {
+    {
+        std::scoped_lock lock{m_mutex};
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+}
+
+void ConsoleLogger::Push(const ConsoleLine& line) {
+    if (m_lines.Push(line)) {
+        m_pushed.fetch_add(1, std::memory_order_release);
+    } else {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ConsoleLogger::Flush() {
+    uint64_t pushed = m_pushed.load(std::memory_order_acquire);
+
+    std::unique_lock lock{m_mutex};
+    m_flush = true;
+    m_cond.notify_all();
+    m_cond.wait(lock, [&] {
+        return m_stop ||
+               m_written.load(std::memory_order_relaxed) >= pushed;
+    });
+}
+
+uint32_t ConsoleLogger::GetDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void ConsoleLogger::Run() {
+    std::unique_lock lock{m_mutex};
+    uint32_t reportedDropped = 0;
+
+    while (true) {
+        m_cond.wait_for(lock, kWritePeriod, [&] { return m_stop || m_flush; });
+        m_flush = false;
+
+        // Producers don't take the mutex, so writing with it held only
+        // delays Flush() callers
+        bool wroteOut = false;
+        bool wroteError = false;
+        uint64_t written = 0;
+        ConsoleLine line;
+        while (m_lines.Pop(line)) {
+            if (line.stream == ConsoleStream::kOut) {
+                std::fwrite(line.text, 1, line.size, stdout);
+                wroteOut = true;
+            } else {
+                std::fwrite(line.text, 1, line.size, stderr);
+                wroteError = true;
+            }
+            ++written;
+        }
+
+        uint32_t dropped = GetDroppedCount();
+        if (dropped != reportedDropped) {
+            fmt::print(stderr, "Console: {} lines dropped\n",
+                       dropped - reportedDropped);
+            reportedDropped = dropped;
+            wroteError = true;
+        }
+
+        if (wroteOut) {
+            std::fflush(stdout);
+        }
+        if (wroteError) {
+            std::fflush(stderr);
+        }
+
+        if (written > 0) {
+            m_written.fetch_add(written, std::memory_order_relaxed);
+            m_cond.notify_all();
+        }
+
+        if (m_stop) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,281 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "telemetry/TelemetryLogger.hpp"
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <system_error>
+
+#include <fmt/compile.h>
+#include <fmt/core.h>
+
+#include "RealTime.hpp"
+#include "telemetry/ConsoleLog.hpp"
+
+using namespace frc3512;
+
+namespace {
+
+struct LogFile {
+    uint64_t number;
+    std::string path;
+    uint64_t size;
+};
+
+/**
+ * Returns the number in a log's file name, or false if it's not a log.
+ */
+bool ParseLogNumber(const std::string& name, uint64_t& number) {
+    constexpr const char* kPrefix = "telemetry-";
+    constexpr const char* kSuffix = ".bin";
+    size_t prefixLength = std::char_traits<char>::length(kPrefix);
+    size_t suffixLength = std::char_traits<char>::length(kSuffix);
+    if (name.size() <= prefixLength + suffixLength ||
+        name.compare(0, prefixLength, kPrefix) != 0 ||
+        name.compare(name.size() - suffixLength, suffixLength, kSuffix) != 0) {
+        return false;
+    }
+
+    auto digits = name.substr(prefixLength,
+                              name.size() - prefixLength - suffixLength);
+    if (!std::all_of(digits.begin(), digits.end(),
+                     [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+
+    number = std::strtoull(digits.c_str(), nullptr, 10);
+    return true;
+}
+
+/**
+ * Returns the logs in a directory from oldest to newest.
+ */
+std::vector<LogFile> ListLogs(const std::string& directory) {
+    std::vector<LogFile> logs;
+    uint64_t number;
+
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find =
+        FindFirstFileA((directory + "/telemetry-*.bin").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (ParseLogNumber(data.cFileName, number)) {
+                logs.push_back({number, directory + "/" + data.cFileName,
+                                (uint64_t{data.nFileSizeHigh} << 32) |
+                                    data.nFileSizeLow});
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir != nullptr) {
+        while (dirent* entry = readdir(dir)) {
+            struct stat status;
+            std::string path = directory + "/" + entry->d_name;
+            if (ParseLogNumber(entry->d_name, number) &&
+                stat(path.c_str(), &status) == 0) {
+                logs.push_back(
+                    {number, path, static_cast<uint64_t>(status.st_size)});
+            }
+        }
+        closedir(dir);
+    }
+#endif
+
+    std::sort(logs.begin(), logs.end(),
+              [](const auto& lhs, const auto& rhs) {
+                  return lhs.number < rhs.number;
+              });
+    return logs;
+}
+
+/**
+ * Returns the bytes available to this process on a directory's filesystem,
+ * or false if that's unknown.
+ */
+bool GetFreeSpace(const std::string& directory, uint64_t& bytes) {
+#ifdef _WIN32
+    ULARGE_INTEGER available;
+    if (!GetDiskFreeSpaceExA(directory.c_str(), &available, nullptr,
+                             nullptr)) {
+        return false;
+    }
+    bytes = available.QuadPart;
+#else
+    struct statvfs status;
+    if (statvfs(directory.c_str(), &status) != 0) {
+        return false;
+    }
+    bytes = static_cast<uint64_t>(status.f_bavail) * status.f_frsize;
+#endif
+    return true;
+}
+
+}  // namespace
+
+uint32_t TelemetryChannelBase::GetDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+TelemetryLogger::~TelemetryLogger() { Stop(); }
+
+std::string TelemetryLogger::MakeLogPath(const std::string& directory,
+                                         uint64_t maxFileSize,
+                                         uint64_t maxTotalSize,
+                                         uint64_t minFreeSpace) {
+    auto logs = ListLogs(directory);
+    uint64_t number = logs.empty() ? 0 : logs.back().number + 1;
+
+    uint64_t totalSize = 0;
+    for (const auto& log : logs) {
+        totalSize += log.size;
+    }
+
+    // Free space is only checked if the platform reports it
+    uint64_t freeSpace = 0;
+    bool knowFreeSpace = GetFreeSpace(directory, freeSpace);
+
+    auto hasRoom = [&] {
+        return totalSize + maxFileSize <= maxTotalSize &&
+               (!knowFreeSpace || freeSpace >= maxFileSize + minFreeSpace);
+    };
+
+    for (const auto& log : logs) {
+        if (hasRoom()) {
+            break;
+        }
+
+        if (std::remove(log.path.c_str()) == 0) {
+            Log(FMT_COMPILE("Telemetry: deleted old log {}\n"), log.path);
+            totalSize -= log.size;
+            freeSpace += log.size;
+        }
+    }
+
+    if (!hasRoom()) {
+        LogError(
+            FMT_COMPILE("Telemetry: not enough space in {} for a new log\n"),
+            directory);
+        return "";
+    }
+
+    return fmt::format("{}/telemetry-{}.bin", directory, number);
+}
+
+bool TelemetryLogger::Start(const std::string& path, uint64_t maxSize) {
+    if (m_thread.joinable()) {
+        return false;
+    }
+
+    try {
+        // fmt's default flags don't truncate an existing file. The stream is
+        // moved to the heap while it's empty since moving one with buffered
+        // data makes its destructor write through a closed file.
+        m_file = std::make_unique<fmt::ostream>(fmt::output_file(
+            path, fmt::file::WRONLY | fmt::file::CREATE | O_TRUNC));
+    } catch (const std::system_error& e) {
+        LogError(FMT_COMPILE("Telemetry: couldn't open {}: {}\n"), path,
+                 e.what());
+        return false;
+    }
+
+    TelemetryLogHeader header;
+    header.recordHeaderSize = sizeof(TelemetryRecordHeader);
+    m_file->print("{}",
+                  fmt::string_view{reinterpret_cast<const char*>(&header),
+                                   sizeof(header)});
+    m_remainingSize = maxSize > sizeof(header) ? maxSize - sizeof(header) : 0;
+
+    m_stop = false;
+    m_thread = std::thread{[=] {
+        SetCurrentThreadBackground();
+        Run();
+    }};
+
+    m_running = true;
+    m_recording = !m_paused;
+    return true;
+}
+
+void TelemetryLogger::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_running = false;
+    m_recording = false;
+    {
+        std::scoped_lock lock{m_mutex};
+        m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+    m_file.reset();
+}
+
+bool TelemetryLogger::IsRunning() const { return m_running; }
+
+void TelemetryLogger::SetPaused(bool paused) {
+    m_paused = paused;
+    m_recording = m_running && !paused;
+}
+
+bool TelemetryLogger::IsPaused() const { return m_paused; }
+
+uint32_t TelemetryLogger::GetDroppedCount() const {
+    std::scoped_lock lock{m_mutex};
+
+    uint32_t dropped = 0;
+    for (const auto& channel : m_channels) {
+        dropped += channel->GetDroppedCount();
+    }
+    return dropped;
+}
+
+void TelemetryLogger::Run() {
+    std::unique_lock lock{m_mutex};
+    uint32_t reportedDropped = 0;
+    bool reportedFull = false;
+
+    while (true) {
+        bool stop = m_cond.wait_for(lock, kWritePeriod, [&] { return m_stop; });
+
+        uint32_t dropped = 0;
+        bool full = false;
+        for (auto& channel : m_channels) {
+            full |= channel->Drain(*m_file, m_remainingSize);
+            dropped += channel->GetDroppedCount();
+        }
+
+        if (full && !reportedFull) {
+            LogError(FMT_COMPILE("Telemetry: log reached its size limit; "
+                                 "discarding records\n"));
+            reportedFull = true;
+        }
+
+        if (dropped != reportedDropped) {
+            LogError(FMT_COMPILE("Telemetry: {} records dropped\n"),
+                     dropped - reportedDropped);
+            reportedDropped = dropped;
+        }
+
+        if (stop) {
+            break;
+        }
+    }
+
+    m_file->close();
+}
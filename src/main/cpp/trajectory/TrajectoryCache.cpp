@@ -0,0 +1,122 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "trajectory/TrajectoryCache.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/compile.h>
+#include <frc/RobotBase.h>
+
+#include "RealTime.hpp"
+#include "telemetry/ConsoleLog.hpp"
+
+using namespace frc3512;
+
+namespace {
+
+// Size of the pages touched to fault in the mapping. Smaller than or equal to
+// the page size on every platform the robot code runs on.
+constexpr size_t kPageSize = 4096;
+
+}  // namespace
+
+bool TrajectoryCache::Load(const std::string& path) {
+    m_entries.clear();
+    m_samples = nullptr;
+    m_file.reset();
+
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(path,
+                                            MappedFile::Access::kRandom);
+    } catch (const std::runtime_error& e) {
+        LogError(FMT_COMPILE("TrajectoryCache: {}\n"), e.what());
+        return false;
+    }
+
+    TrajectoryFileHeader header;
+    if (file->Size() < sizeof(header)) {
+        LogError(FMT_COMPILE("TrajectoryCache: {} is truncated\n"), path);
+        return false;
+    }
+    std::memcpy(&header, file->Data(), sizeof(header));
+    if (header.magic != TrajectoryFileHeader::kMagic) {
+        LogError(FMT_COMPILE("TrajectoryCache: {} isn't a trajectory file\n"),
+                 path);
+        return false;
+    }
+    if (header.version != TrajectoryFileHeader::kVersion) {
+        LogError(
+            FMT_COMPILE("TrajectoryCache: {} has unsupported version {}\n"),
+            path, header.version);
+        return false;
+    }
+
+    // Checked by count first so a corrupt count can't overflow the size
+    if (header.trajectoryCount >
+        (file->Size() - sizeof(header)) / sizeof(TrajectoryEntry)) {
+        LogError(FMT_COMPILE("TrajectoryCache: {} is truncated\n"), path);
+        return false;
+    }
+    size_t samplesOffset =
+        sizeof(header) + header.trajectoryCount * sizeof(TrajectoryEntry);
+    size_t sampleCount =
+        (file->Size() - samplesOffset) / sizeof(TrajectorySample);
+
+    std::vector<TrajectoryEntry> entries(header.trajectoryCount);
+    std::memcpy(entries.data(), file->Data() + sizeof(header),
+                entries.size() * sizeof(TrajectoryEntry));
+    for (auto& entry : entries) {
+        // Guarantee the name is terminated even if the file is corrupt
+        entry.name.back() = '\0';
+
+        if (entry.sampleCount == 0 || entry.period == 0 ||
+            entry.firstSample > sampleCount ||
+            entry.sampleCount > sampleCount - entry.firstSample) {
+            LogError(
+                FMT_COMPILE("TrajectoryCache: {} has an invalid entry {}\n"),
+                path, entry.name.data());
+            return false;
+        }
+    }
+
+    // Touch every page now so the control loop doesn't take page faults the
+    // first time it reads a sample
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < file->Size(); offset += kPageSize) {
+        sink = sink ^ file->Data()[offset];
+    }
+
+    // On the robot, also keep the pages from being evicted under memory
+    // pressure during a match. Simulations load it too often to bother.
+    if constexpr (frc::RobotBase::IsReal()) {
+        if (!LockPages(file->Data(), file->Size())) {
+            LogError(
+                FMT_COMPILE("TrajectoryCache: couldn't lock {} in memory\n"),
+                path);
+        }
+    }
+
+    m_samples =
+        reinterpret_cast<const TrajectorySample*>(file->Data() + samplesOffset);
+    m_entries = std::move(entries);
+    m_file = std::move(file);
+
+    return true;
+}
+
+std::optional<MappedTrajectory> TrajectoryCache::Get(
+    wpi::StringRef name) const {
+    for (const auto& entry : m_entries) {
+        if (name == entry.name.data()) {
+            return MappedTrajectory{
+                m_samples + entry.firstSample, entry.sampleCount,
+                units::microsecond_t{static_cast<double>(entry.period)}};
+        }
+    }
+
+    return std::nullopt;
+}
+
+size_t TrajectoryCache::Size() const { return m_entries.size(); }
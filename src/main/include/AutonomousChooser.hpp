@@ -4,18 +4,25 @@
 
 #include <atomic>
 #include <functional>
+#include <initializer_list>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include <frc/smartdashboard/Sendable.h>
 #include <frc/smartdashboard/SendableBuilder.h>
+#include <frc2/Timer.h>
 #include <networktables/NetworkTableEntry.h>
+#include <units/time.h>
 #include <wpi/StringMap.h>
 #include <wpi/StringRef.h>
 #include <wpi/condition_variable.h>
 #include <wpi/mutex.h>
 
+#include "Coroutine.hpp"
+#include "CoroutinePool.hpp"
+#include "telemetry/TelemetryLogger.hpp"
+
 namespace frc3512 {
 
 /**
@@ -24,6 +31,17 @@ namespace frc3512 {
  */
 class AutonomousChooser : public frc::Sendable {
 public:
+    /**
+     * Selects how the autonomous mode function is run.
+     */
+    enum class ExecutionMode {
+        /// Dedicated thread that hands control back and forth with the main
+        /// robot thread via a condition variable
+        kThread,
+        /// Stackful coroutine on the main robot thread
+        kCoroutine
+    };
+
     /**
      * Constructs an AutonomousChooser.
      *
@@ -40,6 +58,9 @@ public:
     /**
      * Adds an autonomous mode.
      *
+     * Adding a mode with an existing name replaces its function. Modes should
+     * only be added before autonomous mode starts.
+     *
      * @param name Name of autonomous mode.
      * @param func Autonomous mode function.
      */
@@ -48,15 +69,61 @@ public:
     /**
      * Sets the selected autonomous mode for unit testing purposes.
      *
+     * Unknown names are ignored.
+     *
      * @param name Name of autonomous mode.
      */
     void SelectAutonomous(wpi::StringRef name);
 
+    /**
+     * Sets the selected autonomous mode by its index in the order modes were
+     * added, where the default mode is 0, for replaying logged matches.
+     *
+     * Unknown indices are ignored.
+     *
+     * @param index Index of autonomous mode as logged in AutonomousRecord.
+     */
+    void SelectAutonomous(size_t index);
+
     /**
      * Returns a list of selectable autonomous modes for unit testing purposes.
      */
     const std::vector<std::string>& GetAutonomousNames() const;
 
+    /**
+     * Sets how autonomous mode functions are run.
+     *
+     * In kCoroutine mode, YieldToMain() is a stack switch back to the main
+     * robot thread instead of a thread handoff, so no thread has to be woken
+     * up. See Coroutine for what a switch costs. The semantics of
+     * YieldToMain() and Return() are the same in both modes.
+     *
+     * Switching to kThread mode spawns a persistent worker thread that's
+     * pinned to the calling thread's CPU, prefaults its stack, and then parks
+     * until a mode is started. The calling thread isn't pinned. Call this
+     * while the robot is disabled so AwaitStartAutonomous() doesn't pay for
+     * thread creation.
+     *
+     * This should only be called while no autonomous mode is running.
+     *
+     * @param mode Execution mode.
+     */
+    void SetExecutionMode(ExecutionMode mode);
+
+    /**
+     * Returns how autonomous mode functions are run.
+     */
+    ExecutionMode GetExecutionMode() const;
+
+    /**
+     * Logs an AutonomousRecord when each autonomous mode starts and ends.
+     *
+     * This should only be called while no autonomous mode is running.
+     *
+     * @param telemetry Logger to log to. It must outlive the chooser.
+     */
+    void SetTelemetry(TelemetryLogger& telemetry);
+
     /**
      * Yield to main robot thread and wait for next chance to run.
      *
@@ -65,6 +132,66 @@ public:
      */
     void YieldToMain();
 
+    /**
+     * Runs the given functions concurrently until they've all returned.
+     *
+     * Each function gets its own coroutine. Every control cycle, each
+     * unfinished function runs until it yields, then the caller yields to the
+     * main robot thread. This lets an autonomous mode do several things in the
+     * same cycle, like driving while waiting for the shooter to reach its
+     * reference. Calls to YieldToMain() and the Await*() functions inside the
+     * functions yield back to here rather than the main robot thread.
+     *
+     * If a function throws, the others still run to completion and then the
+     * first exception is rethrown.
+     *
+     * This function should only be called by the autonomous mode.
+     *
+     * @param funcs Functions to run concurrently.
+     * @return False if autonomous mode has ended and the caller should return.
+     */
+    bool AwaitAll(std::initializer_list<std::function<void()>> funcs);
+
+    /**
+     * Yield to main robot thread until the next control cycle.
+     *
+     * This function should only be called by the autonomous mode.
+     *
+     * @return False if autonomous mode has ended and the caller should return.
+     */
+    bool AwaitNextCycle();
+
+    /**
+     * Yield to main robot thread until the given amount of time has passed.
+     *
+     * This function should only be called by the autonomous mode.
+     *
+     * @param duration Amount of time to wait.
+     * @return False if autonomous mode has ended and the caller should return.
+     */
+    bool AwaitFor(units::second_t duration);
+
+    /**
+     * Yield to main robot thread until the predicate returns true.
+     *
+     * The predicate is checked before yielding, so this returns immediately if
+     * it's already satisfied.
+     *
+     * This function should only be called by the autonomous mode.
+     *
+     * @param predicate Callable returning bool that's checked every cycle.
+     * @return False if autonomous mode has ended and the caller should return.
+     */
+    template <typename Predicate>
+    bool AwaitUntil(Predicate&& predicate) {
+        while (!predicate()) {
+            if (!AwaitNextCycle()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /**
      * Return to main robot thread.
      *
@@ -74,8 +201,16 @@ public:
 
     /**
      * Runs the selected autonomous mode function.
+     *
+     * The time from initTimestamp until the mode function starts running is
+     * recorded and can be retrieved with GetStartLatency().
+     *
+     * @param initTimestamp FPGA timestamp at the start of AutonomousInit().
+     * @throws std::runtime_error if kCoroutine mode has no free coroutine to
+     *         run the mode on.
      */
-    void AwaitStartAutonomous();
+    void AwaitStartAutonomous(
+        units::second_t initTimestamp = frc2::Timer::GetFPGATimestamp());
 
     /**
      * Notify autonomous mode to run.
@@ -89,12 +224,34 @@ public:
 
     /**
      * Notify autonomous mode so it can exit.
+     *
+     * Blocks until the autonomous mode function returns. AwaitNextCycle(),
+     * AwaitFor(), and AwaitUntil() return false from here on so the function
+     * knows to return.
      */
     void EndAutonomous();
 
+    /**
+     * Returns the time from the start of AutonomousInit() to the first
+     * instruction of the most recently started autonomous mode.
+     */
+    units::second_t GetStartLatency() const;
+
     void InitSendable(frc::SendableBuilder& builder) override;
 
 private:
+    // Autonomous mode functions and anything they run concurrently get their
+    // stacks from here
+    static constexpr size_t kCoroutinePoolSize = 8;
+
+    // Amount of the worker thread's stack to prefault
+    static constexpr size_t kWorkerStackPrefaultSize = 256 * 1024;
+
+    ExecutionMode m_executionMode = ExecutionMode::kCoroutine;
+    CoroutinePool m_coroutinePool{kCoroutinePoolSize};
+    Coroutine* m_autonCoroutine = nullptr;
+    std::atomic<bool> m_cancelled{false};
+
     std::thread m_autonThread;
     wpi::mutex m_mutex;
     wpi::mutex m_autonMutex;
@@ -103,12 +260,32 @@ private:
     wpi::condition_variable m_cond;
     bool m_awaitingAuton = false;
     bool m_autonRunning = false;
+    bool m_stopWorker = false;
+
+    TelemetryChannel<AutonomousRecord>* m_telemetry = nullptr;
+
+    // Index of the mode whose start was logged, or -1 if its end was
+    // logged too
+    int m_loggedIndex = -1;
+
+    units::second_t m_initTimestamp = 0_s;
+    units::second_t m_startLatency = 0_s;
 
     std::string m_defaultChoice;
-    std::string m_selectedChoice;
-    wpi::StringMap<std::function<void()>> m_choices;
+
+    // Autonomous mode functions and their names in the order they were added
+    std::vector<std::function<void()>> m_choices;
+    std::vector<std::string> m_choiceNames;
+
+    // Maps mode names to indices in m_choices. Guarded by m_mutex since the
+    // NetworkTables listener thread resolves selections with it.
+    wpi::StringMap<size_t> m_choiceIndices;
+
+    // Mode names in alphabetical order for the dashboard
     std::vector<std::string> m_names;
-    std::function<void()>* m_selectedAuton;
+
+    std::atomic<size_t> m_selectedIndex{0};
+    std::function<void()>* m_selectedAuton = nullptr;
 
     nt::NetworkTableEntry m_defaultEntry;
     nt::NetworkTableEntry m_optionsEntry;
@@ -116,6 +293,36 @@ private:
     nt::NetworkTableEntry m_activeEntry;
 
     NT_EntryListener m_selectedListenerHandle;
+
+    /**
+     * Runs the autonomous coroutine until it yields and returns it to the
+     * pool once it's done.
+     */
+    void ResumeAutonCoroutine();
+
+    /**
+     * Spawns the thread that runs autonomous modes in kThread mode.
+     */
+    void StartWorker();
+
+    /**
+     * Tells the worker thread to exit and joins it.
+     */
+    void StopWorker();
+
+    /**
+     * Resolves an autonomous mode name and publishes its index as the
+     * selection.
+     *
+     * @param name Name of autonomous mode.
+     * @return False if there's no autonomous mode with that name.
+     */
+    bool SetSelectedIndex(wpi::StringRef name);
+
+    /**
+     * Runs the selected autonomous mode function on the calling thread.
+     */
+    void RunSelectedAuton();
 };
 
 }  // namespace frc3512
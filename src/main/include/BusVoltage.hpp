@@ -0,0 +1,73 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+
+#include <frc/SpeedController.h>
+#include <units/time.h>
+#include <units/voltage.h>
+
+namespace frc3512 {
+
+/**
+ * A cached, low-pass filtered estimate of the robot's bus voltage.
+ *
+ * Update() reads the bus voltage from the HAL once per robot cycle. Get() and
+ * SetVoltage() only read the cached estimate, so actuators can be commanded in
+ * volts from any thread without a HAL call per motor.
+ */
+class BusVoltage {
+public:
+    static constexpr auto kNominalVoltage = 12_V;
+
+    // The estimate isn't allowed below this so a brownout dip doesn't make
+    // SetVoltage() command full output
+    static constexpr auto kMinVoltage = 6_V;
+
+    /**
+     * Constructs a BusVoltage.
+     *
+     * @param timeConstant Time constant of the single-pole IIR filter.
+     * @param period       Period at which Update() is called.
+     */
+    explicit BusVoltage(units::second_t timeConstant = 100_ms,
+                        units::second_t period = 20_ms);
+
+    /**
+     * Samples the bus voltage and updates the filtered estimate.
+     *
+     * The first sample initializes the estimate directly.
+     */
+    void Update();
+
+    /**
+     * Returns the filtered bus voltage.
+     */
+    units::volt_t Get() const;
+
+    /**
+     * Returns the ratio of nominal to bus voltage.
+     *
+     * Duty cycles scaled by this produce the voltage they would at
+     * kNominalVoltage.
+     */
+    double GetCompensationScale() const;
+
+    /**
+     * Sets a motor's duty cycle so that it applies the given voltage.
+     *
+     * @param motor   The motor controller.
+     * @param voltage Voltage to apply.
+     */
+    void SetVoltage(frc::SpeedController& motor, units::volt_t voltage) const;
+
+private:
+    double m_gain;
+    bool m_initialized = false;
+
+    // Filtered bus voltage in volts
+    std::atomic<double> m_voltage{kNominalVoltage.to<double>()};
+};
+
+}  // namespace frc3512
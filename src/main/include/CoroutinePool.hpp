@@ -0,0 +1,56 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Coroutine.hpp"
+
+namespace frc3512 {
+
+/**
+ * A fixed set of coroutines whose stacks are allocated up front.
+ *
+ * Acquiring and releasing a coroutine never allocates, so coroutines can be
+ * handed out during a match without touching the heap. This class isn't
+ * thread-safe.
+ */
+class CoroutinePool {
+public:
+    /**
+     * Constructs a CoroutinePool.
+     *
+     * @param size      Number of coroutines in the pool.
+     * @param stackSize Size of each coroutine's stack in bytes.
+     */
+    explicit CoroutinePool(size_t size,
+                           size_t stackSize = Coroutine::kDefaultStackSize);
+
+    /**
+     * Returns an idle coroutine from the pool, or nullptr if they're all in
+     * use.
+     */
+    Coroutine* Acquire();
+
+    /**
+     * Returns a coroutine to the pool.
+     *
+     * The coroutine's function must have returned.
+     *
+     * @param coroutine Coroutine previously returned by Acquire().
+     */
+    void Release(Coroutine* coroutine);
+
+    /**
+     * Returns the number of idle coroutines in the pool.
+     */
+    size_t Available() const;
+
+private:
+    std::vector<std::unique_ptr<Coroutine>> m_coroutines;
+    std::vector<Coroutine*> m_idle;
+};
+
+}  // namespace frc3512
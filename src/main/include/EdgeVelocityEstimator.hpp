@@ -0,0 +1,116 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <units/time.h>
+
+/**
+ * Estimates the rate of a pulse train from the timestamps of its edges.
+ *
+ * Each edge is recorded with its position, normally the edge count of a
+ * hardware counter on the same signal. The velocity is the slope of a least
+ * squares fit of position against timestamp over a sliding window of recent
+ * edges. Since positions come from the counter rather than the order edges are
+ * reported in, an edge the caller misses only leaves a gap in the window
+ * instead of making two periods look like one.
+ * Optionally, a quadratic is fit instead, which also yields acceleration and
+ * evaluates the velocity at the newest edge instead of the middle of the
+ * window. Extrapolating to the end of the window is several times noisier
+ * than the line's estimate, though, so the line is the default.
+ *
+ * AddEdge() may be called from one thread (e.g., an interrupt handler) while
+ * another calls GetVelocity() or GetAcceleration(). Neither blocks.
+ */
+class EdgeVelocityEstimator {
+public:
+    // Number of edge timestamps retained. Must be larger than the window.
+    static constexpr size_t kBufferSize = 64;
+
+    /**
+     * Constructs an EdgeVelocityEstimator.
+     *
+     * @param windowSize       Number of edges to fit over. Must be at least 3
+     *                         and less than kBufferSize.
+     * @param fitAcceleration  Whether to fit a quadratic instead of a line.
+     * @param maxPeriod        If no edge arrives for this long, the velocity
+     *                         is reported as zero.
+     */
+    explicit EdgeVelocityEstimator(size_t windowSize = 8,
+                                   bool fitAcceleration = false,
+                                   units::second_t maxPeriod = 0.5_s);
+
+    /**
+     * Records an edge.
+     *
+     * Timestamps and positions must be nondecreasing.
+     *
+     * @param timestamp Time at which the edge occurred.
+     * @param position  Number of edges counted up to and including this one.
+     */
+    void AddEdge(units::second_t timestamp, int64_t position);
+
+    /**
+     * Records an edge at the position after the previous edge's.
+     *
+     * This is only accurate if the caller never misses an edge.
+     *
+     * @param timestamp Time at which the edge occurred.
+     */
+    void AddEdge(units::second_t timestamp);
+
+    /**
+     * Discards all recorded edges.
+     *
+     * This must not be called concurrently with AddEdge().
+     */
+    void Reset();
+
+    /**
+     * Returns the estimated velocity in edges per second.
+     *
+     * @param now Current time in the same time base as the edge timestamps.
+     */
+    double GetVelocity(units::second_t now) const;
+
+    /**
+     * Returns the estimated acceleration in edges per second squared.
+     *
+     * This is always zero if acceleration fitting is disabled.
+     *
+     * @param now Current time in the same time base as the edge timestamps.
+     */
+    double GetAcceleration(units::second_t now) const;
+
+private:
+    struct Fit {
+        double velocity = 0.0;
+        double acceleration = 0.0;
+    };
+
+    size_t m_windowSize;
+    bool m_fitAcceleration;
+    units::second_t m_maxPeriod;
+
+    // Ring buffers of edge timestamps in seconds and edge positions
+    std::array<std::atomic<double>, kBufferSize> m_timestamps;
+    std::array<std::atomic<int64_t>, kBufferSize> m_positions;
+
+    // Position of the next edge passed to AddEdge() without one. Only
+    // accessed by the writer.
+    int64_t m_nextPosition = 0;
+
+    // Number of edges ever added. The newest edge is at index
+    // (m_count - 1) % kBufferSize.
+    std::atomic<uint64_t> m_count{0};
+
+    /**
+     * Copies the newest window of edges out of the ring buffers and fits
+     * them.
+     */
+    Fit Calculate(units::second_t now) const;
+};
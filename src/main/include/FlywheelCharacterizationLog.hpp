@@ -0,0 +1,44 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Binary log format written by Shooter's characterization mode and read by the
+ * flywheelSysId tool.
+ *
+ * A log is a FlywheelCharacterizationHeader followed by
+ * FlywheelCharacterizationSample records until the end of the file. Fields are
+ * stored in native byte order, which is little-endian on both the roboRIO and
+ * desktop platforms.
+ */
+
+struct FlywheelCharacterizationHeader {
+    static constexpr std::array<char, 8> kMagic{
+        {'F', 'L', 'Y', 'S', 'Y', 'S', 'I', 'D'}};
+    static constexpr uint32_t kVersion = 1;
+
+    std::array<char, 8> magic = kMagic;
+    uint32_t version = kVersion;
+
+    // Size of each sample record, so readers can reject mismatched layouts
+    uint32_t sampleSize;
+};
+
+struct FlywheelCharacterizationSample {
+    // Time since the start of the characterization in microseconds
+    uint32_t timestamp;
+
+    // Commanded motor voltage in volts
+    float voltage;
+
+    // Measured angular velocity in RPM
+    float angularVelocity;
+};
+
+static_assert(sizeof(FlywheelCharacterizationHeader) == 16,
+              "Characterization log header must be packed");
+static_assert(sizeof(FlywheelCharacterizationSample) == 12,
+              "Characterization log samples must be packed");
@@ -3,29 +3,69 @@
 #pragma once
 
 #include <frc/Counter.h>
+#include <frc/DigitalInput.h>
+#include <hal/SimDevice.h>
 #include <units/angular_velocity.h>
 
+#include "EdgeVelocityEstimator.hpp"
+
 /**
  * This class counts the number of gear teeth which have passed using a Counter
  * and Hall's Effect sensor plugged into a DIO channel. It returns the RPM of
  * the shooter wheel given the gear ratio and number of teeth on the gear.
+ *
+ * In simulation, the rate is read from the "GeartoothEncoder[channel]" sim
+ * device instead, which GeartoothEncoderSim sets.
  */
 class GeartoothEncoder {
 public:
-    GeartoothEncoder(int channel, int teethPerRevolution, double gearRatio);
+    /**
+     * Selects how the angular velocity is estimated.
+     */
+    enum class EstimationMode {
+        /// Counter's period averaged over the last few teeth
+        kCounterPeriod,
+        /// Least squares fit over FPGA timestamps of the last few teeth,
+        /// captured by an interrupt on each rising edge along with the
+        /// Counter's count
+        kEdgeTimestamps
+    };
+
+    GeartoothEncoder(int channel, int teethPerRevolution, double gearRatio,
+                     EstimationMode mode = EstimationMode::kCounterPeriod);
+
+    ~GeartoothEncoder();
 
     /**
      * Returns angular velocity of shooter sheel.
      */
     units::revolutions_per_minute_t GetRate() const;
 
+    /**
+     * Returns the DIO channel of the Hall effect sensor.
+     */
+    int GetChannel() const;
+
 private:
+    // Fed from the rising edge interrupt in kEdgeTimestamps mode. Declared
+    // before m_input so it outlives the interrupt handler. The handler also
+    // reads m_counter, so the destructor cancels the interrupts first.
+    EdgeVelocityEstimator m_estimator;
+
+    frc::DigitalInput m_input;
+
     // Counts number of pulses from Hall effect sensor
-    frc::Counter m_counter;
+    frc::Counter m_counter{&m_input};
 
     // Number of teeth per revolution of gear
     int m_teethPerRevolution;
 
     // Conversion factor between RPM of gear and RPM of shooter wheel
     double m_gearRatio;
+
+    EstimationMode m_mode;
+
+    // Rate in RPM set by GeartoothEncoderSim. Null on the roboRIO.
+    hal::SimDevice m_simDevice;
+    hal::SimDouble m_simRate;
 };
@@ -0,0 +1,126 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <frc/AnalogGyro.h>
+#include <frc/AnalogInput.h>
+#include <units/angular_velocity.h>
+#include <units/time.h>
+
+/**
+ * Owns an AnalogGyro and persists its calibration so the robot doesn't wait
+ * for the gyro's blocking calibration on every boot.
+ *
+ * At construction, the gyro is created with the center and offset saved by
+ * the previous boot. Since those can go stale, the gyro's drift is checked for
+ * kDriftCheckTime. If there's no saved calibration or the gyro drifts faster
+ * than kMaxDriftRate, the gyro's full calibration runs and its result is saved.
+ *
+ * While the robot is disabled and stationary, the calibration is measured
+ * again in the background from the gyro's accumulator and saved if it
+ * changed. Applying it to the running gyro would reset its angle, so it's only
+ * used from the next boot, like after a brownout.
+ *
+ * The file is flushed to disk and replaced atomically, so a brownout during a
+ * save leaves either the previous or the new calibration intact.
+ */
+class GyroCalibrator {
+public:
+    // Same as AnalogGyro's calibration time
+    static constexpr units::second_t kCalibrationTime = 5_s;
+
+    // A stale calibration at this drift rate is off by about 3 degrees at the
+    // end of a match. The check is long enough to resolve it above the gyro's
+    // noise.
+    static constexpr units::second_t kDriftCheckTime = 1_s;
+    static constexpr auto kMaxDriftRate = 0.02_deg_per_s;
+
+    /**
+     * Constructs a GyroCalibrator and its gyro.
+     *
+     * This blocks for kDriftCheckTime with a valid saved calibration, or for
+     * the gyro's full calibration otherwise.
+     *
+     * @param channel Analog input channel of the gyro.
+     * @param path    Path of the calibration file. If it's empty, nothing is
+     *                persisted and the gyro is calibrated like AnalogGyro's
+     *                constructor does.
+     */
+    GyroCalibrator(int channel, std::string path);
+
+    GyroCalibrator(const GyroCalibrator&) = delete;
+    GyroCalibrator& operator=(const GyroCalibrator&) = delete;
+
+    /**
+     * Returns the path the robot persists the calibration to.
+     *
+     * This is in the operating directory, which deploys don't overwrite. It's
+     * empty in simulation so simulated robots don't persist anything.
+     */
+    static std::string GetDefaultPath();
+
+    /**
+     * Returns the gyro.
+     */
+    frc::AnalogGyro& GetGyro();
+
+    /**
+     * Starts a new background calibration.
+     *
+     * This should be called when the robot is disabled.
+     */
+    void StartBackgroundCalibration();
+
+    /**
+     * Advances the background calibration.
+     *
+     * This should be called every robot loop while disabled. Once the robot
+     * has been stationary for kCalibrationTime, the calibration is saved if it
+     * changed and the background calibration stops until it's started again.
+     *
+     * @param stationary True if the robot isn't moving.
+     */
+    void UpdateBackgroundCalibration(bool stationary);
+
+private:
+    struct Calibration {
+        int center;
+        double offset;
+    };
+
+    std::string m_path;
+    std::optional<Calibration> m_saved;
+
+    std::shared_ptr<frc::AnalogInput> m_input;
+    frc::AnalogGyro m_gyro;
+
+    // Background calibration state. The accumulator's value and count are
+    // recorded when the robot starts being stationary.
+    bool m_backgroundDone = true;
+    bool m_backgroundActive = false;
+    units::second_t m_backgroundStartTime = 0_s;
+    int64_t m_startValue = 0;
+    int64_t m_startCount = 0;
+
+    /**
+     * Returns the calibration in a file, or an empty optional if it doesn't
+     * exist or is invalid.
+     */
+    static std::optional<Calibration> Load(const std::string& path);
+
+    /**
+     * Saves a calibration to m_path.
+     */
+    void Save(const Calibration& calibration);
+
+    /**
+     * Returns the gyro's drift rate measured over kDriftCheckTime.
+     */
+    units::degrees_per_second_t MeasureDrift();
+};
@@ -0,0 +1,104 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace frc3512 {
+
+/**
+ * A fixed-size histogram of durations in nanoseconds.
+ *
+ * Buckets are log-linear: each power of two is split into eight equal
+ * buckets, so a duration's bucket bounds it within 12.5%. Durations of
+ * 2^28 ns (about 268 ms) or more go in the last bucket.
+ *
+ * One thread may call Record() while another calls TakeWindow(). Neither
+ * blocks or allocates.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kNumBuckets = 208;
+
+    /**
+     * Statistics for the durations recorded during a window.
+     */
+    struct Window {
+        std::array<uint32_t, kNumBuckets> buckets{};
+        uint32_t count = 0;
+        uint64_t sum = 0;
+
+        // Zero if nothing was recorded
+        uint64_t min = 0;
+        uint64_t max = 0;
+
+        /**
+         * Returns the mean duration in nanoseconds, or zero if nothing was
+         * recorded.
+         */
+        double Mean() const;
+
+        /**
+         * Returns an upper bound on the given percentile in nanoseconds, or
+         * zero if nothing was recorded.
+         *
+         * @param percentile Percentile in [0..100].
+         */
+        uint64_t Percentile(double percentile) const;
+    };
+
+    LatencyHistogram();
+
+    /**
+     * Records a duration.
+     *
+     * This must only be called from one thread.
+     *
+     * @param nanoseconds Duration in nanoseconds.
+     */
+    void Record(uint64_t nanoseconds);
+
+    /**
+     * Returns the statistics for the durations recorded since the last call.
+     *
+     * This must only be called from one thread. Durations recorded
+     * concurrently with this call may be counted in the next window instead.
+     */
+    Window TakeWindow();
+
+    /**
+     * Returns the index of the bucket containing a duration.
+     *
+     * @param nanoseconds Duration in nanoseconds.
+     */
+    static size_t BucketIndex(uint64_t nanoseconds);
+
+    /**
+     * Returns the smallest duration in a bucket in nanoseconds.
+     *
+     * @param index Bucket index.
+     */
+    static uint64_t BucketLowerBound(size_t index);
+
+private:
+    // Cumulative counts. Only Record() writes these, so it doesn't need
+    // read-modify-write operations.
+    std::array<std::atomic<uint32_t>, kNumBuckets> m_buckets;
+    std::atomic<uint32_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+
+    // Extremes since the last TakeWindow(), which resets them
+    std::atomic<uint64_t> m_min{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> m_max{0};
+
+    // Cumulative counts as of the last TakeWindow(). Only it accesses these.
+    std::array<uint32_t, kNumBuckets> m_lastBuckets{};
+    uint32_t m_lastCount = 0;
+    uint64_t m_lastSum = 0;
+};
+
+}  // namespace frc3512
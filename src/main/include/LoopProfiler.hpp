@@ -0,0 +1,156 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <frc/Notifier.h>
+#include <networktables/NetworkTableEntry.h>
+#include <units/time.h>
+#include <wpi/StringRef.h>
+
+#include "LatencyHistogram.hpp"
+
+namespace frc3512 {
+
+/**
+ * Measures how long each stage of a periodic loop takes.
+ *
+ * Each stage's durations go in a LatencyHistogram. Once per publish period,
+ * the min, mean, 99th percentile, and max of each stage over that period are
+ * published to NetworkTables under "LoopTiming/<name>/<stage>" in
+ * microseconds.
+ *
+ * When a loop takes longer than its budget, the overrun is attributed to the
+ * stage that took the longest in that loop. Overrun counts are published
+ * alongside the timings and printed once per publish period.
+ *
+ * @code{.cpp}
+ * void Robot::TeleopPeriodic() {
+ *     auto loop = m_profiler.ProfileLoop();
+ *     {
+ *         auto probe = m_profiler.Probe(kDrive);
+ *         m_drive.DriveCartesian(x, y, z);
+ *     }
+ * }
+ * @endcode
+ *
+ * Probes and loops must only be used from one thread. A probe reads the
+ * steady clock twice and doesn't block, allocate, or lock.
+ */
+class LoopProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Records how long a stage took when destroyed.
+     */
+    class ScopedProbe {
+    public:
+        ScopedProbe(LoopProfiler& profiler, size_t stage);
+        ~ScopedProbe();
+
+        ScopedProbe(const ScopedProbe&) = delete;
+        ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+    private:
+        LoopProfiler& m_profiler;
+        size_t m_stage;
+        Clock::time_point m_start;
+    };
+
+    /**
+     * Records how long a loop took and attributes overruns when destroyed.
+     */
+    class ScopedLoop {
+    public:
+        explicit ScopedLoop(LoopProfiler& profiler);
+        ~ScopedLoop();
+
+        ScopedLoop(const ScopedLoop&) = delete;
+        ScopedLoop& operator=(const ScopedLoop&) = delete;
+
+    private:
+        LoopProfiler& m_profiler;
+        Clock::time_point m_start;
+    };
+
+    /**
+     * Constructs a LoopProfiler.
+     *
+     * @param name          Name of the loop in NetworkTables.
+     * @param stageNames    Names of the stages. Probes refer to stages by
+     *                      their index in this list.
+     * @param budget        Loops longer than this are overruns.
+     * @param publishPeriod Period at which statistics are published.
+     */
+    LoopProfiler(wpi::StringRef name,
+                 std::initializer_list<std::string> stageNames,
+                 units::second_t budget, units::second_t publishPeriod = 1_s);
+
+    LoopProfiler(const LoopProfiler&) = delete;
+    LoopProfiler& operator=(const LoopProfiler&) = delete;
+
+    /**
+     * Returns a guard that times the loop until it's destroyed.
+     */
+    ScopedLoop ProfileLoop();
+
+    /**
+     * Returns a guard that times a stage until it's destroyed.
+     *
+     * @param stage Index of the stage.
+     */
+    ScopedProbe Probe(size_t stage);
+
+private:
+    struct Stage {
+        std::string name;
+        LatencyHistogram histogram;
+
+        // Time spent in this stage during the current loop in nanoseconds
+        uint64_t loopTime = 0;
+
+        std::atomic<uint32_t> overruns{0};
+        uint32_t lastOverruns = 0;
+
+        nt::NetworkTableEntry minEntry;
+        nt::NetworkTableEntry meanEntry;
+        nt::NetworkTableEntry p99Entry;
+        nt::NetworkTableEntry maxEntry;
+        nt::NetworkTableEntry overrunsEntry;
+    };
+
+    std::string m_name;
+    uint64_t m_budget;
+
+    // The last stage is the whole loop
+    std::vector<std::unique_ptr<Stage>> m_stages;
+
+    /**
+     * Adds a stage and its NetworkTables entries.
+     */
+    void AddStage(const std::string& name);
+
+    void StartLoop();
+    void EndLoop(uint64_t nanoseconds);
+
+    void RecordStage(size_t stage, uint64_t nanoseconds);
+
+    /**
+     * Publishes each stage's statistics since the last call.
+     */
+    void Publish();
+
+    // Declared last so publishing stops before the stages are destroyed
+    frc::Notifier m_publisher{[=] { Publish(); }};
+};
+
+}  // namespace frc3512
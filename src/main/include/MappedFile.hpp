@@ -0,0 +1,59 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+public:
+    /**
+     * How the file's contents will be read, which decides the operating
+     * system's read-ahead.
+     */
+    enum class Access {
+        /// Read once from front to back, like a log being decoded
+        kSequential,
+        /// Read anywhere for as long as the file is mapped, like a lookup
+        /// table. The whole file is read ahead.
+        kRandom
+    };
+
+    /**
+     * Maps a file.
+     *
+     * @param path   Path of the file.
+     * @param access How the file will be read.
+     * @throws std::runtime_error if the file couldn't be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path,
+                        Access access = Access::kSequential);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Returns the file's contents, or nullptr if it's empty.
+     */
+    const uint8_t* Data() const;
+
+    /**
+     * Returns the file's size in bytes.
+     */
+    size_t Size() const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,144 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <frc/AnalogGyro.h>
+#include <frc/Encoder.h>
+#include <frc/Notifier.h>
+#include <frc/geometry/Pose2d.h>
+#include <frc/kinematics/MecanumDriveKinematics.h>
+#include <units/angle.h>
+#include <units/length.h>
+#include <units/time.h>
+
+/**
+ * Estimates the mecanum drivetrain's pose on the field from all four wheel
+ * encoders and the gyro.
+ *
+ * Each update passes the wheels' distance changes through the mecanum forward
+ * kinematics, which is a least squares fit of the chassis motion to the four
+ * wheels, so one slipping wheel only moves the estimate by a quarter of its
+ * error. The gyro provides the heading.
+ *
+ * The estimator updates on its own Notifier at a higher rate than the main
+ * robot loop, on a thread at real-time priority kPriority. GetPose() returns a
+ * consistent snapshot from any thread without blocking the Notifier.
+ *
+ * The encoders are passed in MecanumDrive's order. Their distance units are
+ * assumed to be inches, with forward wheel travel positive on every wheel.
+ * The gyro must only be reset through the estimator so it can keep the heading
+ * continuous.
+ */
+class MecanumPoseEstimator {
+public:
+    // Distance between the left and right wheels and between the front and
+    // rear wheels
+    static constexpr auto kTrackWidth = 22_in;
+    static constexpr auto kWheelBase = 20_in;
+
+    static constexpr units::second_t kDefaultPeriod = 5_ms;
+
+    // Real-time priority of the estimator's Notifier thread
+    static constexpr int kPriority = 30;
+
+    /**
+     * Constructs a MecanumPoseEstimator.
+     *
+     * The pose starts at the origin with the gyro's current heading as zero.
+     *
+     * @param frontLeftEncoder  Front-left encoder.
+     * @param rearLeftEncoder   Rear-left encoder.
+     * @param frontRightEncoder Front-right encoder.
+     * @param rearRightEncoder  Rear-right encoder.
+     * @param gyro              Gyro measuring the robot's heading. The
+     *                          estimator resets it.
+     * @param period            Period of the estimator's updates.
+     */
+    MecanumPoseEstimator(const frc::Encoder& frontLeftEncoder,
+                         const frc::Encoder& rearLeftEncoder,
+                         const frc::Encoder& frontRightEncoder,
+                         const frc::Encoder& rearRightEncoder,
+                         frc::AnalogGyro& gyro,
+                         units::second_t period = kDefaultPeriod);
+
+    /**
+     * Returns the pose as of the last update.
+     *
+     * X is forward and Y is left of the robot's starting pose, and the heading
+     * is counterclockwise positive.
+     */
+    frc::Pose2d GetPose() const;
+
+    /**
+     * Resets the gyro and sets the pose.
+     *
+     * @param pose The robot's pose.
+     */
+    void ResetPose(const frc::Pose2d& pose = frc::Pose2d{});
+
+    /**
+     * Resets the gyro and makes the current heading zero without moving the
+     * pose's position.
+     */
+    void ResetHeading();
+
+    /**
+     * Reads the encoders and gyro and updates the pose.
+     *
+     * This is called by the estimator's Notifier every period, so robot code
+     * shouldn't call it.
+     */
+    void Update();
+
+private:
+    // Wheels are indexed front-left, rear-left, front-right, rear-right
+    static constexpr int kWheels = 4;
+
+    std::array<const frc::Encoder*, kWheels> m_encoders;
+    frc::AnalogGyro& m_gyro;
+
+    frc::MecanumDriveKinematics m_kinematics{
+        {kWheelBase / 2, kTrackWidth / 2},
+        {kWheelBase / 2, -kTrackWidth / 2},
+        {-kWheelBase / 2, kTrackWidth / 2},
+        {-kWheelBase / 2, -kTrackWidth / 2}};
+
+    // Guards the integration state, which Update() and the reset functions
+    // modify
+    std::mutex m_mutex;
+    frc::Pose2d m_pose;
+    std::array<units::inch_t, kWheels> m_lastDistances;
+
+    // Heading when the gyro reads zero
+    units::radian_t m_headingOffset = 0_rad;
+
+    // Published pose. The sequence number is odd while a write is in progress,
+    // so readers retry instead of seeing a mix of two poses.
+    std::atomic<uint32_t> m_sequence{0};
+    std::atomic<double> m_x{0.0};
+    std::atomic<double> m_y{0.0};
+    std::atomic<double> m_heading{0.0};
+
+    /**
+     * Resets the gyro and the encoder distances the next update starts from.
+     *
+     * The mutex must be held.
+     */
+    void ResetSensors();
+
+    /**
+     * Publishes m_pose to GetPose().
+     *
+     * The mutex must be held.
+     */
+    void Publish();
+
+    // Declared last so the estimator stops before the members it uses are
+    // destroyed
+    frc::Notifier m_notifier{kPriority, [=] { Update(); }};
+};
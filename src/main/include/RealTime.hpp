@@ -0,0 +1,71 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <thread>
+
+namespace frc3512 {
+
+/**
+ * Faults in and locks the given amount of the calling thread's stack.
+ *
+ * The pages are mapped and pinned in RAM before time-critical code runs on
+ * them, so it doesn't take page faults the first time it recurses that deep.
+ * Locking is best-effort; it's skipped if the process's RLIMIT_MEMLOCK doesn't
+ * allow it.
+ *
+ * @param size Number of bytes of stack to prefault.
+ */
+void PrefaultStack(size_t size);
+
+/**
+ * Faults in and locks a range of memory such as a heap-allocated stack.
+ *
+ * The range is zeroed in the process. Locking is best-effort like in
+ * PrefaultStack().
+ *
+ * @param data Start of the range.
+ * @param size Length of the range in bytes.
+ */
+void LockMemory(void* data, size_t size);
+
+/**
+ * Locks a range of mapped memory in RAM without writing to it.
+ *
+ * Unlike LockMemory(), this works on read-only mappings such as a
+ * memory-mapped file. Pages that aren't resident yet are faulted in.
+ *
+ * @param data Start of the range.
+ * @param size Length of the range in bytes.
+ * @return True if the range was locked.
+ */
+bool LockPages(const void* data, size_t size);
+
+/**
+ * Returns the CPU the calling thread is running on, or -1 if that's unknown.
+ */
+int GetCurrentCpu();
+
+/**
+ * Restricts a thread to run only on the given CPU.
+ *
+ * This is a no-op on platforms without thread affinity support.
+ *
+ * @param thread Thread to pin.
+ * @param cpu    CPU index.
+ * @return True on success.
+ */
+bool PinThreadToCpu(std::thread& thread, int cpu);
+
+/**
+ * Lowers the calling thread's priority below that of normal threads.
+ *
+ * Background work like logging uses this so it only runs when nothing else
+ * needs the CPU. This is a no-op on platforms without per-thread priorities.
+ *
+ * @return True on success.
+ */
+bool SetCurrentThreadBackground();
+
+}  // namespace frc3512
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <frc/AnalogGyro.h>
 #include <frc/Encoder.h>
 #include <frc/Joystick.h>
@@ -10,19 +12,52 @@
 #include <frc/Talon.h>
 #include <frc/TimedRobot.h>
 #include <frc/drive/MecanumDrive.h>
-#include <wpi/raw_ostream.h>
+#include <frc/geometry/Pose2d.h>
+#include <units/impedance.h>
+#include <units/time.h>
+#include <units/voltage.h>
 
 #include "AutonomousChooser.hpp"
+#include "BusVoltage.hpp"
+#include "GyroCalibrator.hpp"
+#include "LoopProfiler.hpp"
+#include "MecanumPoseEstimator.hpp"
+#include "controllers/HolonomicTrajectoryController.hpp"
+#include "controllers/MecanumVelocityController.hpp"
+#include "simulation/MecanumDriveSim.hpp"
 #include "subsystems/Feeder.hpp"
 #include "subsystems/Shooter.hpp"
+#include "telemetry/ConsoleLog.hpp"
+#include "telemetry/TelemetryLogger.hpp"
+#include "trajectory/TrajectoryCache.hpp"
+
+/**
+ * Maps a joystick's Z axis to [0..1] in steps of 1/500.
+ *
+ * The axis is at 0 when pushed all the way forward.
+ *
+ * @param stick Joystick to read.
+ */
+double ScaleZ(frc::Joystick& stick);
 
 class Robot : public frc::TimedRobot {
 public:
     enum class ShooterAngle { kHigh, kLow };
     enum class UnderglowColor { kBlue, kRed, kOff };
 
+    enum class DriveMode {
+        /// Duty cycles from MecanumDrive
+        kOpenLoop,
+        /// Wheel velocities tracked by MecanumVelocityController
+        kClosedLoop
+    };
+
     Robot();
 
+    void RobotPeriodic() override;
+
+    void SimulationPeriodic() override;
+
     void AutonomousInit() override;
     void AutonomousPeriodic() override;
 
@@ -31,16 +66,198 @@ public:
     void AutonLeftMove();
     void AutonTwoDisc();
 
+    // Autonomous primitives. Each one yields to the main robot thread every
+    // cycle, prints how long it ran, and returns false if autonomous mode
+    // ended before it finished.
+
+    /**
+     * Follows a generated trajectory, then stops.
+     *
+     * The trajectory's poses are in the pose estimator's frame, which starts
+     * at the origin in autonomous mode. The drive tracks the trajectory with
+     * HolonomicTrajectoryController. Its wheel velocities are tracked in
+     * closed-loop mode and converted to the matching duty cycles in open-loop
+     * mode. After the trajectory's end, it keeps
+     * correcting toward the final pose until it's within tolerance or a
+     * timeout passes.
+     *
+     * An error is printed and nothing is followed if there's no trajectory
+     * with the given name.
+     *
+     * @param name Name of the trajectory's path file without the extension.
+     */
+    bool FollowTrajectory(const char* name);
+
+    /**
+     * Waits for the given amount of time.
+     *
+     * @param duration Time to wait.
+     */
+    bool WaitFor(units::second_t duration);
+
+    /**
+     * Waits until the shooter reaches its reference or the timeout passes.
+     *
+     * @param timeout Maximum time to wait.
+     */
+    bool WaitForShooter(units::second_t timeout);
+
+    /**
+     * Feeds frisbees into the shooter one at a time.
+     *
+     * The first frisbee is fed as soon as the feeder is idle if the shooter is
+     * at its reference, or once the interval has passed otherwise. Each one
+     * after that is fed once the interval has passed since the previous one
+     * and the feeder is idle.
+     *
+     * @param count    Number of frisbees to feed.
+     * @param interval Minimum time between frisbees.
+     */
+    bool FeedDiscs(unsigned int count, units::second_t interval);
+
     void TeleopInit() override;
     void TeleopPeriodic() override;
 
     void DisabledInit() override;
+    void DisabledPeriodic() override;
+
+    // Test mode runs the shooter characterization and saves the log to the
+    // operating directory when it finishes
+    void TestInit() override;
+    void TestPeriodic() override;
 
     void SetShooterAngle(ShooterAngle angle);
     void SetUnderglowColor(UnderglowColor color);
 
+    /**
+     * Selects how drive commands are turned into motor outputs.
+     *
+     * The drive is open-loop by default. Closed-loop mode's gains come from
+     * the simulation model, so it should only be selected once the drive has
+     * been characterized and every encoder's polarity has been checked on the
+     * robot. A reversed encoder makes its wheel's feedback positive.
+     *
+     * @param mode Drive mode.
+     */
+    void SetDriveMode(DriveMode mode);
+
+    /**
+     * Drives the robot with the selected drive mode.
+     *
+     * The arguments are the same as MecanumDrive::DriveCartesian()'s.
+     *
+     * @param ySpeed    Speed along the Y axis [-1.0..1.0]. Right is positive.
+     * @param xSpeed    Speed along the X axis [-1.0..1.0]. Forward is
+     *                  positive.
+     * @param zRotation Rotation rate [-1.0..1.0]. Clockwise is positive.
+     * @param gyroAngle Gyro angle in degrees for field-oriented driving.
+     */
+    void Drive(double ySpeed, double xSpeed, double zRotation,
+               double gyroAngle = 0.0);
+
+    /**
+     * Returns the autonomous mode chooser for selecting modes in simulation.
+     */
+    frc3512::AutonomousChooser& GetAutonomousChooser();
+
+    /**
+     * Returns the shooter for configuring it in simulation.
+     */
+    Shooter& GetShooter();
+
+    /**
+     * Returns the feeder for reading its state in simulation.
+     */
+    const Feeder& GetFeeder() const;
+
+    /**
+     * Returns the drivetrain's pose estimated from the wheel encoders and
+     * gyro.
+     */
+    frc::Pose2d GetEstimatedPose() const;
+
+    /**
+     * Returns the drivetrain simulation.
+     */
+    MecanumDriveSim& GetDriveSim();
+
+    /**
+     * Sets the simulated battery's open-circuit voltage and internal
+     * resistance.
+     *
+     * @param voltage    Open-circuit voltage.
+     * @param resistance Internal resistance.
+     */
+    void SetSimulatedBattery(units::volt_t voltage, units::ohm_t resistance);
+
+    /**
+     * Returns the driver station and sensor inputs the periodic functions
+     * read.
+     */
+    frc3512::InputRecord GetInputs() const;
+
+    /**
+     * Returns the state of every actuator.
+     */
+    frc3512::OutputRecord GetOutputs() const;
+
+    /**
+     * Sets the driver station and sensor inputs in simulation and notifies
+     * the driver station of new data.
+     *
+     * Buttons that weren't down in the previous inputs are reported as
+     * pressed.
+     *
+     * @param inputs Inputs for the next robot loop iteration.
+     */
+    void SetSimulatedInputs(const frc3512::InputRecord& inputs);
+
+    /**
+     * Enables or disables the drivetrain and battery models in simulation.
+     *
+     * They're enabled by default. Disable them so the sensors and bus voltage
+     * set by SetSimulatedInputs() aren't overwritten.
+     *
+     * @param enabled Whether the models update every robot loop.
+     */
+    void SetSimulatedPhysicsEnabled(bool enabled);
+
 private:
-    frc::AnalogGyro m_gyro{0};
+    /**
+     * Drives each wheel at a velocity with MecanumVelocityController.
+     *
+     * @param references Wheel velocity references in m/s in MecanumDrive's
+     *                   order.
+     */
+    void DriveWheelVelocities(
+        const MecanumVelocityController::WheelVector& references);
+
+    // Declared first so it outlives everything that logs to it
+    frc3512::TelemetryLogger m_telemetry;
+
+    // FPGA timestamp of the last robot loop iteration that ran enabled, which
+    // decides when logging pauses after the robot is disabled
+    std::optional<units::second_t> m_lastEnabledTime;
+
+    // Stages of the periodic functions timed by m_loopProfiler
+    enum LoopStage : size_t {
+        kJoysticks,
+        kShooter,
+        kFeeder,
+        kSolenoids,
+        kDrive,
+        kAutonomous
+    };
+
+    frc3512::LoopProfiler m_loopProfiler{
+        "Robot",
+        {"Joysticks", "Shooter", "Feeder", "Solenoids", "Drive", "Autonomous"},
+        kDefaultPeriod};
+
+    // Skips the gyro's blocking calibration at startup when a recent one was
+    // saved
+    GyroCalibrator m_gyroCalibrator{0, GyroCalibrator::GetDefaultPath()};
+    frc::AnalogGyro& m_gyro = m_gyroCalibrator.GetGyro();
 
     frc::Joystick m_driveStick{1};
     frc::Joystick m_shootStick{2};
@@ -57,16 +274,46 @@ private:
     frc::Encoder m_rlEncoder{6, 5, true};
     frc::Encoder m_rrEncoder{8, 7, true};
     frc::MecanumDrive m_drive{m_flMotor, m_frMotor, m_rlMotor, m_rrMotor};
+    MecanumVelocityController m_driveController{kDefaultPeriod};
+    HolonomicTrajectoryController m_trajectoryController;
+    DriveMode m_driveMode = DriveMode::kOpenLoop;
+    MecanumDriveSim m_driveSim{m_flMotor,   m_frMotor,   m_rlMotor,
+                               m_rrMotor,   m_flEncoder, m_frEncoder,
+                               m_rlEncoder, m_rrEncoder, m_gyro};
+
+    // Only reset the gyro through the estimator
+    MecanumPoseEstimator m_poseEstimator{m_flEncoder, m_frEncoder, m_rlEncoder,
+                                         m_rrEncoder, m_gyro};
+
+    // Autonomous trajectories, mapped from the deploy directory at startup
+    frc3512::TrajectoryCache m_trajectories;
+
+    frc3512::TelemetryChannel<frc3512::InputRecord>& m_inputTelemetry =
+        m_telemetry.AddChannel<frc3512::InputRecord>();
+    frc3512::TelemetryChannel<frc3512::OutputRecord>& m_outputTelemetry =
+        m_telemetry.AddChannel<frc3512::OutputRecord>();
 
     frc::Relay m_underGlow{5};
 
-    Feeder m_feeder;
-    Shooter m_shooter;
+    // Updated once per robot cycle and shared by every voltage-commanded
+    // actuator
+    frc3512::BusVoltage m_busVoltage;
+
+    Feeder m_feeder{m_telemetry};
+    Shooter m_shooter{m_busVoltage, m_telemetry};
+
+    // Simulated battery, which sags under the drive and shooter current draw
+    units::volt_t m_simBatteryVoltage = 12_V;
+    units::ohm_t m_simBatteryResistance = 0.02_Ohm;
+    bool m_simPhysicsEnabled = true;
+
+    // True once the log from the current test mode run has been saved
+    bool m_characterizationSaved = false;
 
     // Field-oriented driving by default
     bool m_isGyroEnabled = true;
 
     // Used for timing in all Autonomous routines
     frc3512::AutonomousChooser m_autonChooser{
-        "No-op", [] { wpi::outs() << "No-op autonomous\n"; }};
+        "No-op", [] { frc3512::Log(FMT_COMPILE("No-op autonomous\n")); }};
 };
@@ -0,0 +1,40 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+
+#include <units/angular_acceleration.h>
+#include <units/angular_velocity.h>
+#include <units/voltage.h>
+
+/**
+ * Feedforward constants of the flywheel model
+ * V = kS sgn(ω) + kV ω + kA dω/dt.
+ *
+ * They're identified from a characterization log by the flywheelSysId tool,
+ * which writes them to a JSON file in the deploy directory.
+ */
+struct FlywheelConstants {
+    // Voltage needed to overcome static friction
+    units::volt_t kS = 0_V;
+
+    // Voltage per angular velocity. The default is the hand-tuned 5000 RPM
+    // free speed at 12 V.
+    decltype(1_V / 1_rad_per_s) kV = 12_V / 5000_rpm;
+
+    // Voltage per angular acceleration
+    decltype(1_V / 1_rad_per_s_sq) kA = 0.001_V / 1_rad_per_s_sq;
+
+    /**
+     * Loads constants from a JSON file written by flywheelSysId.
+     *
+     * The file's "kS", "kV", and "kA" entries are in volts, volts per rad/s,
+     * and volts per rad/s². If the file is missing or can't be parsed, the
+     * defaults are returned and a message is printed. Missing entries keep
+     * their defaults.
+     *
+     * @param path Path of the JSON file.
+     */
+    static FlywheelConstants Load(const std::string& path);
+};
@@ -0,0 +1,49 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <units/angular_velocity.h>
+#include <units/voltage.h>
+
+/**
+ * Interface for flywheel velocity controllers.
+ *
+ * Implementations aren't thread-safe; they're only used from the thread that
+ * runs the shooter's control loop.
+ */
+class FlywheelController {
+public:
+    virtual ~FlywheelController() = default;
+
+    /**
+     * Sets the flywheel's reference angular velocity.
+     *
+     * @param angularVelocity Reference angular velocity.
+     */
+    virtual void SetReference(
+        units::revolutions_per_minute_t angularVelocity) = 0;
+
+    /**
+     * Returns true if the flywheel has reached the reference as of the last
+     * call to Update().
+     */
+    virtual bool AtReference() const = 0;
+
+    /**
+     * Resets the controller's internal state.
+     *
+     * This should be called before the first Update() after the controller has
+     * been idle.
+     *
+     * @param angularVelocity Current angular velocity of the flywheel.
+     */
+    virtual void Reset(units::revolutions_per_minute_t angularVelocity) = 0;
+
+    /**
+     * Runs one controller iteration and returns the voltage to apply.
+     *
+     * @param angularVelocity Measured angular velocity of the flywheel.
+     */
+    virtual units::volt_t Update(
+        units::revolutions_per_minute_t angularVelocity) = 0;
+};
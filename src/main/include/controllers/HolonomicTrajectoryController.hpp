@@ -0,0 +1,61 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <frc/geometry/Pose2d.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/length.h>
+#include <units/velocity.h>
+
+#include "controllers/MecanumVelocityController.hpp"
+#include "trajectory/TrajectoryFormat.hpp"
+
+/**
+ * Tracks a trajectory's field pose and velocity with a mecanum drivetrain.
+ *
+ * Each update feeds forward the trajectory sample's field velocity and angular
+ * velocity and adds proportional feedback on the x, y, and heading errors.
+ * Since a mecanum drive can move in any direction while turning, the three
+ * errors are corrected independently. The resulting chassis velocity is
+ * rotated into the robot's frame with the estimated heading and converted to
+ * wheel velocity references for MecanumVelocityController.
+ *
+ * Updates only do fixed-size matrix math, so they don't allocate.
+ */
+class HolonomicTrajectoryController {
+public:
+    using WheelVector = MecanumVelocityController::WheelVector;
+
+    // Field velocity commanded per meter of position error
+    static constexpr auto kTranslationGain = 3_mps / 1_m;
+
+    // Angular velocity commanded per radian of heading error
+    static constexpr auto kRotationGain = 4_rad_per_s / 1_rad;
+
+    static constexpr auto kPositionTolerance = 2_in;
+    static constexpr auto kHeadingTolerance = 2_deg;
+
+    /**
+     * Returns wheel velocity references that drive the robot from its pose
+     * toward a trajectory sample.
+     *
+     * If any wheel's reference exceeds MecanumVelocityController::kMaxSpeed,
+     * all four are scaled down together.
+     *
+     * @param pose      The robot's estimated pose.
+     * @param reference The trajectory sample for the current time.
+     * @return Wheel velocity references in m/s in MecanumDrive's order.
+     */
+    WheelVector Calculate(const frc::Pose2d& pose,
+                          const frc3512::TrajectorySample& reference);
+
+    /**
+     * Returns true if the pose was within tolerance of the reference at the
+     * last Calculate().
+     */
+    bool AtReference() const;
+
+private:
+    bool m_atReference = false;
+};
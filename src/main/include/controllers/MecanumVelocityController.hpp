@@ -0,0 +1,93 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <Eigen/Core>
+#include <units/acceleration.h>
+#include <units/time.h>
+#include <units/velocity.h>
+#include <units/voltage.h>
+
+/**
+ * Tracks a velocity reference on each wheel of a mecanum drivetrain with a
+ * kV/kA feedforward from the wheels' model plus proportional feedback.
+ *
+ * The four wheels are updated together as vectors, so one Update() per robot
+ * cycle computes every wheel's feedforward and feedback. If any wheel's voltage
+ * exceeds the limit, all four are scaled down together so the ratios between
+ * them, and with them the direction of travel, are kept.
+ *
+ * Wheels are in MecanumDrive's order: front-left, rear-left, front-right,
+ * rear-right. Velocities are in meters per second with forward wheel travel
+ * positive, and voltages are before MecanumDrive's right side inversion.
+ *
+ * This isn't thread-safe; it's only used from the main robot thread.
+ */
+class MecanumVelocityController {
+public:
+    using WheelVector = Eigen::Matrix<double, 4, 1>;
+
+    // Per-wheel velocity model in volts per m/s and volts per m/s². These
+    // match MecanumDriveSim's model until the drive is characterized.
+    static constexpr auto kV = 4_V / 1_mps;
+    static constexpr auto kA = 0.4_V / 1_mps_sq;
+
+    // Volts applied per m/s of velocity error
+    static constexpr auto kP = 6_V / 1_mps;
+
+    // Wheel speed for a full drive command. It's below the free speed at
+    // nominal voltage so feedback has headroom when the battery sags.
+    static constexpr auto kMaxSpeed = 2.5_mps;
+
+    static constexpr auto kMaxVoltage = 12_V;
+
+    // Same as MecanumDrive's default
+    static constexpr double kDeadband = 0.02;
+
+    /**
+     * Constructs a MecanumVelocityController.
+     *
+     * @param dt Controller period.
+     */
+    explicit MecanumVelocityController(units::second_t dt);
+
+    /**
+     * Converts a Cartesian drive command to wheel velocity references.
+     *
+     * The arguments are the same as MecanumDrive::DriveCartesian()'s, and the
+     * wheel speeds are mixed and normalized the same way, then scaled by
+     * kMaxSpeed.
+     *
+     * @param ySpeed    Speed along the Y axis [-1.0..1.0]. Right is positive.
+     * @param xSpeed    Speed along the X axis [-1.0..1.0]. Forward is
+     *                  positive.
+     * @param zRotation Rotation rate [-1.0..1.0]. Clockwise is positive.
+     * @param gyroAngle Gyro angle in degrees for field-oriented driving.
+     * @return Wheel velocity references in m/s.
+     */
+    static WheelVector CartesianToWheelSpeeds(double ySpeed, double xSpeed,
+                                              double zRotation,
+                                              double gyroAngle = 0.0);
+
+    /**
+     * Clears the previous references used for the acceleration feedforward.
+     *
+     * This should be called before the first Update() after the drive has
+     * been idle.
+     */
+    void Reset();
+
+    /**
+     * Runs one controller iteration and returns the voltages to apply.
+     *
+     * @param references Wheel velocity references in m/s.
+     * @param velocities Measured wheel velocities in m/s.
+     * @return Wheel voltages in volts.
+     */
+    WheelVector Update(const WheelVector& references,
+                       const WheelVector& velocities);
+
+private:
+    units::second_t m_dt;
+    WheelVector m_lastReferences = WheelVector::Zero();
+};
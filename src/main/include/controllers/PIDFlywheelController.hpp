@@ -0,0 +1,43 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <frc/controller/PIDController.h>
+#include <units/angular_velocity.h>
+#include <units/time.h>
+#include <units/voltage.h>
+
+#include "controllers/FlywheelConstants.hpp"
+#include "controllers/FlywheelController.hpp"
+
+/**
+ * A PID flywheel controller with a kS/kV feedforward on the reference.
+ */
+class PIDFlywheelController : public FlywheelController {
+public:
+    // Voltage corresponding to a PID output of 1.0
+    static constexpr auto kNominalVoltage = 12_V;
+
+    /**
+     * Constructs a PIDFlywheelController.
+     *
+     * @param constants Flywheel model constants used for the feedforward.
+     * @param dt        Controller period.
+     */
+    PIDFlywheelController(const FlywheelConstants& constants,
+                          units::second_t dt);
+
+    void SetReference(units::revolutions_per_minute_t angularVelocity) override;
+
+    bool AtReference() const override;
+
+    void Reset(units::revolutions_per_minute_t angularVelocity) override;
+
+    units::volt_t Update(
+        units::revolutions_per_minute_t angularVelocity) override;
+
+private:
+    FlywheelConstants m_constants;
+    frc2::PIDController m_controller;
+    bool m_atReference = false;
+};
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <frc/controller/LinearQuadraticRegulator.h>
+#include <frc/estimator/KalmanFilter.h>
+#include <frc/system/LinearSystem.h>
+#include <frc/system/LinearSystemLoop.h>
+#include <units/angular_acceleration.h>
+#include <units/angular_velocity.h>
+#include <units/time.h>
+#include <units/voltage.h>
+
+#include "controllers/FlywheelConstants.hpp"
+#include "controllers/FlywheelController.hpp"
+
+/**
+ * A model-based flywheel controller.
+ *
+ * The flywheel is modeled as a first-order velocity system identified by its
+ * kV and kA, with kS added as a feedforward. A Kalman filter estimates the
+ * angular velocity from the noisy encoder measurements and the applied
+ * voltage, and an LQR computes the voltage from the error between the
+ * reference and the estimate. Unlike the PID controller, the gains come from
+ * the model and the tolerances below rather than hand tuning, so the flywheel
+ * spins up as fast as the voltage limit allows without overshoot.
+ */
+class StateSpaceFlywheelController : public FlywheelController {
+public:
+    static constexpr auto kMaxVoltage = 12_V;
+
+    // Standard deviations of the model and the encoder measurement
+    static constexpr auto kModelStdDev = 3_rad_per_s;
+    static constexpr auto kMeasurementStdDev = 5_rad_per_s;
+
+    // LQR tolerances: the velocity error at which the controller applies the
+    // maximum voltage
+    static constexpr auto kVelocityTolerance = 100_rpm;
+
+    /**
+     * Constructs a StateSpaceFlywheelController.
+     *
+     * @param constants Flywheel model constants.
+     * @param dt        Controller period.
+     */
+    StateSpaceFlywheelController(const FlywheelConstants& constants,
+                                 units::second_t dt);
+
+    void SetReference(units::revolutions_per_minute_t angularVelocity) override;
+
+    bool AtReference() const override;
+
+    void Reset(units::revolutions_per_minute_t angularVelocity) override;
+
+    units::volt_t Update(
+        units::revolutions_per_minute_t angularVelocity) override;
+
+    /**
+     * Returns the Kalman filter's angular velocity estimate.
+     */
+    units::revolutions_per_minute_t GetEstimatedAngularVelocity() const;
+
+private:
+    units::second_t m_dt;
+    units::volt_t m_kS;
+
+    frc::LinearSystem<1, 1, 1> m_plant;
+    frc::KalmanFilter<1, 1, 1> m_observer;
+    frc::LinearQuadraticRegulator<1, 1> m_lqr;
+
+    // Holds references to the plant, LQR, and observer, so it's declared
+    // after them
+    frc::LinearSystemLoop<1, 1, 1> m_loop;
+
+    units::radians_per_second_t m_reference = 0_rad_per_s;
+    bool m_atReference = false;
+};
@@ -0,0 +1,31 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <hal/SimDevice.h>
+#include <units/angular_velocity.h>
+
+#include "GeartoothEncoder.hpp"
+
+/**
+ * Sets the rate a GeartoothEncoder reports in simulation.
+ */
+class GeartoothEncoderSim {
+public:
+    /**
+     * Constructs a GeartoothEncoderSim.
+     *
+     * @param encoder The encoder to simulate.
+     */
+    explicit GeartoothEncoderSim(const GeartoothEncoder& encoder);
+
+    /**
+     * Sets the angular velocity of the shooter wheel.
+     *
+     * @param angularVelocity Angular velocity.
+     */
+    void SetRate(units::revolutions_per_minute_t angularVelocity);
+
+private:
+    hal::SimDouble m_simRate;
+};
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+#include <frc/AnalogGyro.h>
+#include <frc/Encoder.h>
+#include <frc/SpeedController.h>
+#include <frc/geometry/Pose2d.h>
+#include <frc/kinematics/MecanumDriveKinematics.h>
+#include <frc/simulation/AnalogGyroSim.h>
+#include <frc/simulation/EncoderSim.h>
+#include <frc/simulation/LinearSystemSim.h>
+#include <frc/system/plant/DCMotor.h>
+#include <units/angular_velocity.h>
+#include <units/current.h>
+#include <units/length.h>
+#include <units/time.h>
+#include <units/velocity.h>
+
+#include "MecanumPoseEstimator.hpp"
+
+/**
+ * Simulates the mecanum drivetrain from the commanded motor outputs and writes
+ * the results to the drive encoders and gyro.
+ *
+ * Each wheel is modeled as a first-order velocity system driven by its motor's
+ * voltage. The wheel speeds are combined through the mecanum kinematics to get
+ * the chassis motion. The true pose can be slowed relative to the wheels by a
+ * slip fraction, and noise can be added to the sensor readings.
+ *
+ * The motors and encoders are passed in MecanumDrive's order. Like
+ * MecanumDrive, the right side motors' outputs are inverted.
+ */
+class MecanumDriveSim {
+public:
+    // Per-wheel velocity model in volts per m/s and volts per m/s². The free
+    // speed at 12 V is 3 m/s.
+    static constexpr auto kV = 4_V / 1_mps;
+    static constexpr auto kA = 0.4_V / 1_mps_sq;
+
+    static constexpr auto kWheelRadius = 3_in;
+    static constexpr double kGearing = 14.0;
+
+    // The wheel layout the robot's pose estimator assumes
+    static constexpr auto kTrackWidth = MecanumPoseEstimator::kTrackWidth;
+    static constexpr auto kWheelBase = MecanumPoseEstimator::kWheelBase;
+
+    /**
+     * Constructs a MecanumDriveSim.
+     *
+     * The encoders' distance units are assumed to be inches.
+     *
+     * @param frontLeftMotor    Front-left motor.
+     * @param rearLeftMotor     Rear-left motor.
+     * @param frontRightMotor   Front-right motor.
+     * @param rearRightMotor    Rear-right motor.
+     * @param frontLeftEncoder  Front-left encoder.
+     * @param rearLeftEncoder   Rear-left encoder.
+     * @param frontRightEncoder Front-right encoder.
+     * @param rearRightEncoder  Rear-right encoder.
+     * @param gyro              Gyro measuring the robot's heading.
+     */
+    MecanumDriveSim(frc::SpeedController& frontLeftMotor,
+                    frc::SpeedController& rearLeftMotor,
+                    frc::SpeedController& frontRightMotor,
+                    frc::SpeedController& rearRightMotor,
+                    const frc::Encoder& frontLeftEncoder,
+                    const frc::Encoder& rearLeftEncoder,
+                    const frc::Encoder& frontRightEncoder,
+                    const frc::Encoder& rearRightEncoder,
+                    const frc::AnalogGyro& gyro);
+
+    /**
+     * Steps the model by the given time using the motors' current outputs,
+     * then updates the sensors.
+     *
+     * Sensors reset by robot code between updates continue from their reset
+     * values.
+     *
+     * @param dt Time since the last update.
+     */
+    void Update(units::second_t dt);
+
+    /**
+     * Returns the total current drawn by the drive motors as of the last
+     * update.
+     */
+    units::ampere_t GetCurrentDraw() const;
+
+    /**
+     * Returns the robot's true pose relative to where it started.
+     *
+     * The pose includes wheel slip, which the encoders and gyro don't see.
+     */
+    frc::Pose2d GetPose() const;
+
+    /**
+     * Sets the fraction of wheel motion lost to slip.
+     *
+     * The encoders still measure the wheels' motion.
+     *
+     * @param slip Slip fraction [0.0..1.0).
+     */
+    void SetWheelSlip(double slip);
+
+    /**
+     * Adds Gaussian noise to the sensor readings.
+     *
+     * Encoder noise is added to each distance reading. Gyro noise is added to
+     * the rate before integration, so the angle drifts as a random walk.
+     *
+     * @param encoderStdDev  Standard deviation of encoder distance noise.
+     * @param gyroRateStdDev Standard deviation of gyro rate noise.
+     * @param seed           Seed of the noise generator.
+     */
+    void SetMeasurementNoise(units::inch_t encoderStdDev,
+                             units::degrees_per_second_t gyroRateStdDev,
+                             uint32_t seed);
+
+private:
+    // Wheels are indexed front-left, rear-left, front-right, rear-right
+    static constexpr int kWheels = 4;
+
+    std::array<frc::SpeedController*, kWheels> m_motors;
+    std::array<frc::sim::EncoderSim, kWheels> m_encoderSims;
+    frc::sim::AnalogGyroSim m_gyroSim;
+
+    std::array<frc::sim::LinearSystemSim<1, 1, 1>, kWheels> m_wheelSims;
+
+    // Distance written to each encoder and the count it produced. If an
+    // encoder's count no longer matches, robot code reset it.
+    std::array<units::inch_t, kWheels> m_distances;
+    std::array<int, kWheels> m_lastCounts;
+
+    frc::DCMotor m_motor = frc::DCMotor::CIM();
+    frc::MecanumDriveKinematics m_kinematics;
+
+    units::ampere_t m_currentDraw = 0_A;
+
+    frc::Pose2d m_pose;
+    double m_slip = 0.0;
+
+    std::mt19937 m_generator;
+    std::normal_distribution<double> m_noise;
+    units::inch_t m_encoderStdDev = 0_in;
+    units::degrees_per_second_t m_gyroRateStdDev = 0_deg_per_s;
+
+    /**
+     * Returns a sample of zero-mean Gaussian noise.
+     *
+     * No random numbers are drawn if the standard deviation is zero.
+     *
+     * @param stdDev Standard deviation.
+     */
+    double SampleNoise(double stdDev);
+};
@@ -6,6 +6,8 @@
 #include <frc2/Timer.h>
 #include <units/time.h>
 
+#include "telemetry/TelemetryLogger.hpp"
+
 /* Notes:
  *
  * For each solenoid, 'false' represents the default position of the actuator.
@@ -17,6 +19,14 @@
 
 class Feeder {
 public:
+    /**
+     * Constructs a Feeder.
+     *
+     * @param telemetry Logger for the feeder's state. It must outlive the
+     *                  Feeder.
+     */
+    explicit Feeder(frc3512::TelemetryLogger& telemetry);
+
     /**
      * Starts process of pushing frisbee into shooter.
      */
@@ -27,12 +37,29 @@ public:
      */
     bool IsFeeding();
 
+    /**
+     * Returns the number of frisbees fed into the shooter since construction.
+     */
+    unsigned int GetTotalShot() const;
+
+    /**
+     * Returns true if the feed actuator is pushing a frisbee into the shooter.
+     */
+    bool IsFeedExtended() const;
+
+    /**
+     * Returns true if the shooter guard is lowered.
+     */
+    bool IsGuardLowered() const;
+
     /**
      * Continues transition of feeder state.
      */
     void Update();
 
 private:
+    frc3512::TelemetryChannel<frc3512::FeederRecord>& m_telemetry;
+
     frc::Solenoid m_frisbeeFeed{1};
     frc2::Timer m_feedTimer;
 
@@ -53,4 +80,7 @@ private:
 
     // Number of frisbees to shoot since feeder was last activated
     unsigned int m_totalToShoot = 0;
+
+    // Number of frisbees shot since construction
+    unsigned int m_lifetimeShot = 0;
 };
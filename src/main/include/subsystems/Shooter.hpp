@@ -2,17 +2,76 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <frc/Notifier.h>
 #include <frc/Talon.h>
-#include <frc/controller/PIDController.h>
+#include <frc/simulation/FlywheelSim.h>
 #include <units/angular_velocity.h>
+#include <units/current.h>
+#include <units/time.h>
 
+#include "BusVoltage.hpp"
+#include "FlywheelCharacterizationLog.hpp"
 #include "GeartoothEncoder.hpp"
+#include "controllers/FlywheelConstants.hpp"
+#include "controllers/PIDFlywheelController.hpp"
+#include "controllers/StateSpaceFlywheelController.hpp"
+#include "simulation/GeartoothEncoderSim.hpp"
+#include "telemetry/TelemetryLogger.hpp"
 
+/**
+ * The flywheel controller runs on its own Notifier at a higher rate than the
+ * main robot loop, on a thread at real-time priority kControllerPriority. The
+ * public functions only exchange references and status with it through
+ * atomics, so they're safe to call from any thread.
+ *
+ * The controllers compute voltages, which are converted to duty cycles with
+ * the cached bus voltage so the flywheel's response doesn't change as the
+ * battery sags.
+ *
+ * The controllers' model constants are loaded from flywheel.json in the deploy
+ * directory. That file is generated by the flywheelSysId tool from a log
+ * recorded by the characterization mode.
+ *
+ * Every controller update logs a ShooterRecord from the controller thread.
+ */
 class Shooter {
 public:
+    enum class ControllerType {
+        /// PID controller with a reference feedforward
+        kPID,
+        /// Kalman filter and LQR based on a model of the flywheel
+        kStateSpace
+    };
+
     static constexpr auto kMaxSpeed = 5000_rpm;
 
-    Shooter();
+    static constexpr units::second_t kDefaultControllerPeriod = 5_ms;
+
+    // Real-time priority of the controller's Notifier thread. It's above the
+    // pose estimator's since the flywheel has the tighter loop.
+    static constexpr int kControllerPriority = 40;
+
+    /**
+     * Constructs a Shooter.
+     *
+     * @param busVoltage       Bus voltage estimate used to convert controller
+     *                         voltages to duty cycles. It must outlive the
+     *                         Shooter.
+     * @param telemetry        Logger for the flywheel's state. It must outlive
+     *                         the Shooter.
+     * @param controllerPeriod Period of the flywheel controller.
+     */
+    Shooter(const frc3512::BusVoltage& busVoltage,
+            frc3512::TelemetryLogger& telemetry,
+            units::second_t controllerPeriod = kDefaultControllerPeriod);
 
     /**
      * Enables shooter controller.
@@ -29,6 +88,21 @@ public:
      */
     bool IsEnabled() const;
 
+    /**
+     * Selects the flywheel controller.
+     *
+     * The new controller is reset from the current measurement on its next
+     * update.
+     *
+     * @param type Controller type.
+     */
+    void SetControllerType(ControllerType type);
+
+    /**
+     * Returns the selected flywheel controller type.
+     */
+    ControllerType GetControllerType() const;
+
     /**
      * Sets the flywheel's reference angular velocity.
      *
@@ -42,14 +116,152 @@ public:
     bool AtReference() const;
 
     /**
-     * Updates motor outputs with controller output.
+     * Returns the flywheel's angular velocity as of the last controller
+     * update.
+     */
+    units::revolutions_per_minute_t GetAngularVelocity() const;
+
+    /**
+     * Returns the duty cycle commanded to the flywheel motors before
+     * inversion.
+     */
+    double GetMotorOutput() const;
+
+    /**
+     * Starts the characterization script.
+     *
+     * The script applies a slow voltage ramp followed by voltage steps, with
+     * coasting periods in between, and records the voltage and angular
+     * velocity every controller period. The controller is disabled while it
+     * runs. Calling Enable() or Disable() stops it early.
+     */
+    void StartCharacterization();
+
+    /**
+     * Returns true if the characterization script is running.
+     */
+    bool IsCharacterizing() const;
+
+    /**
+     * Writes the samples recorded by the last characterization run to a
+     * binary log.
+     *
+     * See FlywheelCharacterizationLog.hpp for the format.
+     *
+     * @param path Path of the log file.
+     * @return False if characterization is running or the file couldn't be
+     *         written.
+     */
+    bool SaveCharacterization(const std::string& path);
+
+    /**
+     * Returns the current drawn by the flywheel motors in simulation.
+     *
+     * This is always zero on the robot.
+     */
+    units::ampere_t GetSimulatedCurrentDraw() const;
+
+    /**
+     * Adds Gaussian noise to the simulated encoder's rate.
+     *
+     * This must be called before the simulation starts stepping the
+     * controller.
+     *
+     * @param stdDev Standard deviation of the noise.
+     * @param seed   Seed of the noise generator.
+     */
+    void SetSimulatedMeasurementNoise(units::revolutions_per_minute_t stdDev,
+                                      uint32_t seed);
+
+    /**
+     * Replaces the simulated flywheel model with a function that returns the
+     * measured angular velocity for each controller update.
+     *
+     * The function is called from the controller's Notifier. This must be
+     * called before the simulation starts stepping the controller.
+     *
+     * @param source Function returning the measurement, or nullptr to use the
+     *               model again.
+     */
+    void SetSimulatedMeasurementSource(
+        std::function<units::revolutions_per_minute_t()> source);
+
+    /**
+     * Runs one iteration of the flywheel controller and updates the motor
+     * outputs.
+     *
+     * This is called by the shooter's Notifier every controller period, so
+     * robot code shouldn't call it.
      */
     void Update();
 
 private:
+    const frc3512::BusVoltage& m_busVoltage;
+    frc3512::TelemetryChannel<frc3512::ShooterRecord>& m_telemetry;
+    FlywheelConstants m_constants;
+
     frc::Talon m_motor1{9};
     frc::Talon m_motor2{10};
-    GeartoothEncoder m_encoder{9, 56, 4.0};
-    frc2::PIDController m_controller{0.0015, 0.000096, 0.0, 20_ms};
-    bool m_enabled = false;
+    GeartoothEncoder m_encoder{
+        9, 56, 4.0, GeartoothEncoder::EstimationMode::kEdgeTimestamps};
+    PIDFlywheelController m_pidController;
+    StateSpaceFlywheelController m_stateSpaceController;
+    units::second_t m_controllerPeriod;
+
+    // The flywheel model is stepped every controller period in simulation,
+    // right before the controller reads the encoder
+    frc::sim::FlywheelSim m_flywheelSim;
+    GeartoothEncoderSim m_encoderSim{m_encoder};
+
+    // Simulated current draw in amps
+    std::atomic<double> m_simCurrentDraw{0.0};
+
+    std::mt19937 m_simGenerator;
+    std::normal_distribution<double> m_simNoise;
+    units::revolutions_per_minute_t m_simNoiseStdDev = 0_rpm;
+    std::function<units::revolutions_per_minute_t()> m_simMeasurementSource;
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<ControllerType> m_controllerType{ControllerType::kPID};
+
+    // Controller that ran on the last update, or nullptr if the shooter was
+    // disabled. Only accessed by Update().
+    FlywheelController* m_activeController = nullptr;
+
+    // Reference in RPM
+    std::atomic<double> m_reference{0.0};
+
+    std::atomic<bool> m_atReference{false};
+
+    // Measured angular velocity in RPM
+    std::atomic<double> m_angularVelocity{0.0};
+
+    std::atomic<bool> m_characterizing{false};
+
+    // Guards the characterization samples, which Update() appends to while
+    // characterization is running
+    std::mutex m_characterizationMutex;
+    std::vector<FlywheelCharacterizationSample> m_characterizationSamples;
+    units::second_t m_characterizationStart = 0_s;
+
+    /**
+     * Applies the characterization script's voltage for the current time and
+     * records a sample.
+     *
+     * @param angularVelocity Measured angular velocity.
+     * @return The applied voltage.
+     */
+    units::volt_t UpdateCharacterization(
+        units::revolutions_per_minute_t angularVelocity);
+
+    /**
+     * Steps the flywheel model with the motors' current output and updates
+     * the simulated encoder, or sets the encoder from the measurement source
+     * if there is one.
+     */
+    void UpdateSimulation();
+
+    // Declared last so the controller stops before the members it uses are
+    // destroyed
+    frc::Notifier m_notifier{kControllerPriority, [=] { Update(); }};
 };
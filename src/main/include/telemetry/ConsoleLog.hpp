@@ -0,0 +1,175 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include <fmt/compile.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "telemetry/MpscRing.hpp"
+
+namespace frc3512 {
+
+/**
+ * Console streams a ConsoleLine can be written to.
+ */
+enum class ConsoleStream : uint8_t { kOut, kError };
+
+/**
+ * A formatted line of console output.
+ *
+ * Lines are fixed-size so they can be formatted on the stack and queued
+ * without allocating. Longer lines are truncated with "...\n".
+ */
+struct ConsoleLine {
+    static constexpr size_t kCapacity = 252;
+
+    ConsoleStream stream;
+    uint8_t reserved = 0;
+    uint16_t size;
+    char text[kCapacity];
+};
+
+static_assert(sizeof(ConsoleLine) == 256, "ConsoleLine must be packed");
+
+/**
+ * Formats a console line with a format string compiled by FMT_COMPILE().
+ *
+ * @param stream Stream to write the line to.
+ * @param format Format string wrapped in FMT_COMPILE().
+ * @param args   Arguments to format.
+ */
+template <typename S, typename... Args>
+ConsoleLine FormatConsoleLine(ConsoleStream stream, const S& format,
+                              const Args&... args) {
+    static_assert(fmt::detail::is_compiled_string<S>::value,
+                  "Wrap log format strings in FMT_COMPILE() so they're "
+                  "checked and compiled at build time");
+
+    ConsoleLine line;
+    line.stream = stream;
+
+    auto result =
+        fmt::format_to_n(line.text, ConsoleLine::kCapacity, format, args...);
+    if (result.size > ConsoleLine::kCapacity) {
+        constexpr char kEllipsis[] = "...\n";
+        constexpr size_t kEllipsisSize = sizeof(kEllipsis) - 1;
+        std::memcpy(line.text + ConsoleLine::kCapacity - kEllipsisSize,
+                    kEllipsis, kEllipsisSize);
+    }
+    line.size = static_cast<uint16_t>(
+        std::min<size_t>(result.size, ConsoleLine::kCapacity));
+
+    return line;
+}
+
+/**
+ * Writes console lines from any thread to stdout and stderr in the
+ * background.
+ *
+ * Log() and LogError() format on the calling thread's stack and queue the
+ * finished line, so they never allocate, block, or make system calls. A
+ * low-priority writer thread wakes up every write period and writes the
+ * queued lines. If it falls behind, lines are dropped and the number dropped
+ * is reported.
+ *
+ * The writer thread starts on the first use and is stopped at exit after the
+ * remaining lines are written.
+ */
+class ConsoleLogger {
+public:
+    // Number of lines that can be queued between writer thread wakeups
+    static constexpr size_t kCapacity = 256;
+
+    static constexpr std::chrono::milliseconds kWritePeriod{20};
+
+    /**
+     * Returns the process's console logger.
+     */
+    static ConsoleLogger& GetInstance();
+
+    ~ConsoleLogger();
+
+    ConsoleLogger(const ConsoleLogger&) = delete;
+    ConsoleLogger& operator=(const ConsoleLogger&) = delete;
+
+    /**
+     * Queues a line for the writer thread.
+     *
+     * @param line Line to write.
+     */
+    void Push(const ConsoleLine& line);
+
+    /**
+     * Blocks until every line queued before the call has been written.
+     */
+    void Flush();
+
+    /**
+     * Returns the number of lines dropped because the queue was full.
+     */
+    uint32_t GetDroppedCount() const;
+
+private:
+    MpscRing<ConsoleLine, kCapacity> m_lines;
+    std::atomic<uint32_t> m_dropped{0};
+
+    // Lines queued and written so far, for Flush()
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_written{0};
+
+    wpi::mutex m_mutex;
+    wpi::condition_variable m_cond;
+    bool m_stop = false;
+    bool m_flush = false;
+
+    std::thread m_thread;
+
+    ConsoleLogger();
+
+    /**
+     * Writes the queued lines every write period until stopped.
+     */
+    void Run();
+};
+
+/**
+ * Logs a line to stdout without allocating or blocking.
+ *
+ * Usage:
+ * @code{.cpp}
+ * frc3512::Log(FMT_COMPILE("{} autonomous\n"), name);
+ * @endcode
+ *
+ * @param format Format string wrapped in FMT_COMPILE(), including the
+ *               newline.
+ * @param args   Arguments to format.
+ */
+template <typename S, typename... Args>
+void Log(const S& format, const Args&... args) {
+    ConsoleLogger::GetInstance().Push(
+        FormatConsoleLine(ConsoleStream::kOut, format, args...));
+}
+
+/**
+ * Logs a line to stderr without allocating or blocking.
+ *
+ * @param format Format string wrapped in FMT_COMPILE(), including the
+ *               newline.
+ * @param args   Arguments to format.
+ */
+template <typename S, typename... Args>
+void LogError(const S& format, const Args&... args) {
+    ConsoleLogger::GetInstance().Push(
+        FormatConsoleLine(ConsoleStream::kError, format, args...));
+}
+
+}  // namespace frc3512
@@ -0,0 +1,112 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace frc3512 {
+
+/**
+ * A fixed-capacity, lock-free queue for any number of producer threads and one
+ * consumer thread.
+ *
+ * Each slot carries a sequence number that says whether it's free for the
+ * producer claiming that position or full for the consumer, so producers only
+ * contend on one compare-and-swap of the head index. Push() and Pop() never
+ * block, allocate, or make system calls. Push() fails instead of overwriting
+ * when the queue is full.
+ *
+ * @tparam T        Element type. It should be trivially copyable.
+ * @tparam Capacity Maximum number of elements. Must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    MpscRing() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * Appends an element.
+     *
+     * This may be called from any thread.
+     *
+     * @param value Element to append.
+     * @return False if the queue was full.
+     */
+    bool Push(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[head & (Capacity - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+            // The slot is free once the consumer has released it for this lap
+            if (sequence == head) {
+                if (m_head.compare_exchange_weak(head, head + 1,
+                                                 std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (sequence < head) {
+                // The consumer hasn't freed the slot from the previous lap
+                return false;
+            } else {
+                // Another producer claimed this position first
+                head = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = value;
+        slot->sequence.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the oldest element.
+     *
+     * This must only be called from the consumer thread. An element whose
+     * producer is still copying it in reads as empty until it's done, even if
+     * newer elements are ready.
+     *
+     * @param value Receives the element.
+     * @return False if the queue was empty.
+     */
+    bool Pop(T& value) {
+        Slot& slot = m_slots[m_tail & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+
+        value = slot.value;
+
+        // Free the slot for the producer that claims it on the next lap
+        slot.sequence.store(m_tail + Capacity, std::memory_order_release);
+        ++m_tail;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    // The producers' and consumer's indices are on separate cache lines so
+    // they don't contend. Indices increase without wrapping at Capacity.
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) size_t m_tail = 0;
+
+    alignas(64) std::array<Slot, Capacity> m_slots;
+};
+
+}  // namespace frc3512
@@ -0,0 +1,84 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace frc3512 {
+
+/**
+ * A fixed-capacity, lock-free queue for one producer thread and one consumer
+ * thread.
+ *
+ * Push() and Pop() never block, allocate, or make system calls. Push() fails
+ * instead of overwriting when the queue is full.
+ *
+ * @tparam T        Element type. It should be trivially copyable.
+ * @tparam Capacity Maximum number of elements. Must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    /**
+     * Appends an element.
+     *
+     * This must only be called from the producer thread.
+     *
+     * @param value Element to append.
+     * @return False if the queue was full.
+     */
+    bool Push(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail == Capacity) {
+            // Only touch the consumer's cache line when the queue looks full
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail == Capacity) {
+                return false;
+            }
+        }
+
+        m_buffer[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the oldest element.
+     *
+     * This must only be called from the consumer thread.
+     *
+     * @param value Receives the element.
+     * @return False if the queue was empty.
+     */
+    bool Pop(T& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+
+        value = m_buffer[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // The producer's and consumer's indices are on separate cache lines so
+    // they don't contend. Indices increase without wrapping at Capacity.
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;
+
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;
+
+    alignas(64) std::array<T, Capacity> m_buffer;
+};
+
+}  // namespace frc3512
@@ -0,0 +1,271 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/os.h>
+#include <frc/RobotController.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "telemetry/SpscRing.hpp"
+#include "telemetry/TelemetryRecords.hpp"
+
+namespace frc3512 {
+
+/**
+ * Queue of records that's drained by TelemetryLogger's writer thread.
+ */
+class TelemetryChannelBase {
+public:
+    virtual ~TelemetryChannelBase() = default;
+
+    /**
+     * Writes the queued records to a file.
+     *
+     * This is only called by the writer thread.
+     *
+     * @param file      File to write to.
+     * @param remaining Number of bytes the file may still grow by. It's
+     *                  reduced by the size of each record written, and records
+     *                  that don't fit are discarded.
+     * @return True if any records were discarded because they didn't fit.
+     */
+    virtual bool Drain(fmt::ostream& file, uint64_t& remaining) = 0;
+
+    /**
+     * Returns the number of records dropped because the queue was full.
+     */
+    uint32_t GetDroppedCount() const;
+
+protected:
+    std::atomic<uint32_t> m_dropped{0};
+};
+
+/**
+ * A single-producer queue of one record type.
+ *
+ * Log() must only be called from one thread. It never blocks, allocates, or
+ * makes system calls; if the writer thread falls behind, records are dropped
+ * instead.
+ *
+ * @tparam Record Record struct from TelemetryRecords.hpp.
+ */
+template <typename Record>
+class TelemetryChannel : public TelemetryChannelBase {
+public:
+    // Number of records that can be queued between writer thread wakeups
+    static constexpr size_t kCapacity = 512;
+
+    /**
+     * Constructs a TelemetryChannel.
+     *
+     * @param recording Whether the logger is recording. Records are discarded
+     *                  while it's false.
+     */
+    explicit TelemetryChannel(const std::atomic<bool>& recording)
+        : m_recording{recording} {}
+
+    /**
+     * Queues a record stamped with the current FPGA time.
+     *
+     * @param record Record to log.
+     */
+    void Log(const Record& record) {
+        if (!m_recording.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        Entry entry;
+        entry.header.timestamp = frc::RobotController::GetFPGATime();
+        entry.header.type = Record::kType;
+        entry.header.size = sizeof(Record);
+        entry.record = record;
+        if (!m_ring.Push(entry)) {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+        }
+    }
+
+    bool Drain(fmt::ostream& file, uint64_t& remaining) override {
+        bool discarded = false;
+        Entry entry;
+        while (m_ring.Pop(entry)) {
+            if (remaining < sizeof(entry)) {
+                discarded = true;
+                continue;
+            }
+
+            file.print("{}",
+                       fmt::string_view{reinterpret_cast<const char*>(&entry),
+                                        sizeof(entry)});
+            remaining -= sizeof(entry);
+        }
+        return discarded;
+    }
+
+private:
+    struct Entry {
+        TelemetryRecordHeader header;
+        Record record;
+    };
+
+    static_assert(sizeof(Entry) ==
+                      sizeof(TelemetryRecordHeader) + sizeof(Record),
+                  "Telemetry records must be packed");
+
+    const std::atomic<bool>& m_recording;
+    SpscRing<Entry, kCapacity> m_ring;
+};
+
+/**
+ * Writes telemetry records to a binary log in the background.
+ *
+ * Each source of records gets its own TelemetryChannel so every queue has a
+ * single producer. A low-priority writer thread wakes up every write period,
+ * drains the channels, and writes the records through a buffered file. See
+ * TelemetryRecords.hpp for the format.
+ *
+ * Channels are added before logging starts and live as long as the logger.
+ *
+ * The roboRIO's user partition is small, so each log stops growing at a
+ * maximum size, and MakeLogPath() deletes the oldest logs in a directory to
+ * keep the total bounded and leave free space for everything else.
+ */
+class TelemetryLogger {
+public:
+    static constexpr std::chrono::milliseconds kWritePeriod{100};
+
+    // Default size limit of one log. Records past it are discarded.
+    static constexpr uint64_t kMaxFileSize = 16 * 1024 * 1024;
+
+    // Default size limit of every log in a directory, including a new one at
+    // its maximum size
+    static constexpr uint64_t kMaxTotalSize = 64 * 1024 * 1024;
+
+    // Default space to leave free on the filesystem after a new log reaches
+    // its maximum size
+    static constexpr uint64_t kMinFreeSpace = 32 * 1024 * 1024;
+
+    TelemetryLogger() = default;
+    ~TelemetryLogger();
+
+    TelemetryLogger(const TelemetryLogger&) = delete;
+    TelemetryLogger& operator=(const TelemetryLogger&) = delete;
+
+    /**
+     * Adds a channel for a record type.
+     *
+     * @tparam Record Record struct from TelemetryRecords.hpp.
+     */
+    template <typename Record>
+    TelemetryChannel<Record>& AddChannel() {
+        auto channel =
+            std::make_unique<TelemetryChannel<Record>>(m_recording);
+        auto& ref = *channel;
+
+        std::scoped_lock lock{m_mutex};
+        m_channels.emplace_back(std::move(channel));
+        return ref;
+    }
+
+    /**
+     * Returns the path for a new log in a directory after deleting old logs to
+     * make room for it.
+     *
+     * Logs are named telemetry-<n>.bin, where n is one more than the newest
+     * log's, so they sort by age even if the clock wasn't set when they were
+     * written. The oldest logs are deleted until the rest plus a new log of
+     * maxFileSize bytes fit in maxTotalSize, and until the filesystem would
+     * still have minFreeSpace bytes free once the new log reaches
+     * maxFileSize.
+     *
+     * @param directory    Directory of the logs.
+     * @param maxFileSize  Size limit of the new log.
+     * @param maxTotalSize Size limit of every log in the directory.
+     * @param minFreeSpace Space to leave free on the filesystem.
+     * @return The new log's path, or an empty string if there isn't enough
+     *         free space even with every old log deleted.
+     */
+    static std::string MakeLogPath(const std::string& directory,
+                                   uint64_t maxFileSize = kMaxFileSize,
+                                   uint64_t maxTotalSize = kMaxTotalSize,
+                                   uint64_t minFreeSpace = kMinFreeSpace);
+
+    /**
+     * Opens a log file and starts the writer thread.
+     *
+     * An existing file at the path is overwritten. Logging starts unpaused.
+     *
+     * @param path    Path of the log file.
+     * @param maxSize Size limit of the log in bytes, including its header.
+     *                Records past it are discarded.
+     * @return False if the logger is already running or the file couldn't be
+     *         opened.
+     */
+    bool Start(const std::string& path, uint64_t maxSize = kMaxFileSize);
+
+    /**
+     * Writes the remaining records, closes the log, and stops the writer
+     * thread.
+     */
+    void Stop();
+
+    /**
+     * Returns true if the log is open.
+     */
+    bool IsRunning() const;
+
+    /**
+     * Pauses or resumes recording.
+     *
+     * Records logged while paused are discarded, but the log stays open, so
+     * resuming doesn't start a new file.
+     *
+     * @param paused True to pause recording.
+     */
+    void SetPaused(bool paused);
+
+    /**
+     * Returns true if recording is paused.
+     */
+    bool IsPaused() const;
+
+    /**
+     * Returns the total number of records dropped because a channel was full.
+     */
+    uint32_t GetDroppedCount() const;
+
+private:
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_paused{false};
+
+    // True while running and not paused. Channels read this on every Log().
+    std::atomic<bool> m_recording{false};
+
+    mutable wpi::mutex m_mutex;
+    wpi::condition_variable m_cond;
+    bool m_stop = false;
+    std::vector<std::unique_ptr<TelemetryChannelBase>> m_channels;
+
+    // Only accessed by the writer thread while it's running
+    std::unique_ptr<fmt::ostream> m_file;
+    uint64_t m_remainingSize = 0;
+
+    std::thread m_thread;
+
+    /**
+     * Drains the channels into the log file every write period until stopped.
+     */
+    void Run();
+};
+
+}  // namespace frc3512
@@ -0,0 +1,340 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+
+/**
+ * Binary telemetry log format written by TelemetryLogger.
+ *
+ * A log is a TelemetryLogHeader followed by records until the end of the file.
+ * Each record is a TelemetryRecordHeader followed by the record type's struct.
+ * Fields are stored in native byte order, which is little-endian on both the
+ * roboRIO and desktop platforms.
+ *
+ * Every struct's size is a multiple of 8 bytes with explicit reserved fields
+ * instead of padding, so records can be copied to disk as-is.
+ *
+ * Each record type's TelemetrySchema lists its fields. The telemetryDecoder
+ * tool generates its output columns from these, so adding a field here is
+ * enough for it to be decoded.
+ */
+
+namespace frc3512 {
+
+// Type 3 was a drive record that InputRecord and OutputRecord replaced. Only
+// version 1 logs have it, and the decoder skips it like any unknown type.
+enum class TelemetryRecordType : uint16_t {
+    kShooter = 1,
+    kFeeder = 2,
+    kAutonomous = 4,
+    kInput = 5,
+    kOutput = 6
+};
+
+struct TelemetryLogHeader {
+    static constexpr std::array<char, 8> kMagic{
+        {'F', 'R', 'C', '3', '5', '1', '2', 'T'}};
+
+    // Version 2 added the drive encoder rates to InputRecord. The decoder still
+    // reads version 1 logs.
+    static constexpr uint32_t kVersion = 2;
+
+    std::array<char, 8> magic = kMagic;
+    uint32_t version = kVersion;
+
+    // Size of each record header, so readers can reject mismatched layouts
+    uint32_t recordHeaderSize;
+};
+
+struct TelemetryRecordHeader {
+    // FPGA timestamp in microseconds
+    uint64_t timestamp;
+
+    TelemetryRecordType type;
+
+    // Size of the record after this header in bytes
+    uint16_t size;
+
+    uint32_t reserved = 0;
+};
+
+/**
+ * Logged by Shooter every controller period.
+ */
+struct ShooterRecord {
+    static constexpr TelemetryRecordType kType = TelemetryRecordType::kShooter;
+
+    // Reference and measured angular velocities in RPM
+    float reference;
+    float angularVelocity;
+
+    // Commanded motor voltage in volts
+    float voltage;
+
+    uint8_t enabled;
+    uint8_t atReference;
+    uint8_t characterizing;
+
+    // Shooter::ControllerType
+    uint8_t controllerType;
+};
+
+/**
+ * Logged by Feeder every update.
+ */
+struct FeederRecord {
+    static constexpr TelemetryRecordType kType = TelemetryRecordType::kFeeder;
+
+    // Frisbees shot and to shoot since the feeder was last activated
+    uint32_t numShot;
+    uint32_t totalToShoot;
+
+    // Frisbees shot since construction
+    uint32_t lifetimeShot;
+
+    uint8_t activated;
+    uint8_t feedExtended;
+    uint8_t guardLowered;
+    uint8_t reserved = 0;
+};
+
+/**
+ * Logged by Robot every robot loop with the inputs its periodic functions
+ * read. LogReplayer feeds these back to the robot code in simulation.
+ *
+ * The flywheel's measured angular velocity is in ShooterRecord instead, since
+ * it's read every controller period.
+ */
+struct InputRecord {
+    static constexpr TelemetryRecordType kType = TelemetryRecordType::kInput;
+
+    // Joystick X, Y, and Z axes [-1..1]. The Z axis is also the twist axis.
+    float driveX;
+    float driveY;
+    float driveZ;
+    float shootX;
+    float shootY;
+    float shootZ;
+
+    // Joystick button states with button 1 in the least significant bit
+    uint32_t driveButtons;
+    uint32_t shootButtons;
+
+    // Drive encoder counts
+    int32_t flCount;
+    int32_t rlCount;
+    int32_t frCount;
+    int32_t rrCount;
+
+    // Drive encoder rates in inches per second
+    float flRate;
+    float rlRate;
+    float frRate;
+    float rrRate;
+
+    // Gyro angle in degrees
+    float gyroAngle;
+
+    // Bus voltage in volts
+    float batteryVoltage;
+
+    // Driver station mode
+    uint8_t enabled;
+    uint8_t autonomous;
+    uint8_t test;
+
+    uint8_t reserved = 0;
+    uint32_t reserved2 = 0;
+};
+
+/**
+ * Logged by Robot every robot loop with the state of every actuator.
+ */
+struct OutputRecord {
+    static constexpr TelemetryRecordType kType = TelemetryRecordType::kOutput;
+
+    // Motor outputs [-1..1] before inversion
+    float flOutput;
+    float rlOutput;
+    float frOutput;
+    float rrOutput;
+    float shooterOutput;
+
+    // Solenoid states
+    uint8_t shooterAngle;
+    uint8_t climbArms;
+    uint8_t feedExtended;
+    uint8_t guardLowered;
+
+    // frc::Relay::Value of the underglow
+    uint8_t underglow;
+
+    uint8_t reserved = 0;
+    uint16_t reserved2 = 0;
+    uint32_t reserved3 = 0;
+};
+
+/**
+ * Logged by AutonomousChooser when an autonomous mode starts and ends.
+ */
+struct AutonomousRecord {
+    static constexpr TelemetryRecordType kType =
+        TelemetryRecordType::kAutonomous;
+
+    enum Event : uint8_t { kStarted = 0, kEnded = 1 };
+
+    // Index of the mode in the order modes were added to the chooser, where
+    // the default mode is 0
+    uint32_t modeIndex;
+
+    // Time from AutonomousInit() to the mode's first instruction in seconds
+    float startLatency;
+
+    Event event;
+
+    // For kEnded, whether the mode returned on its own before it was ended
+    uint8_t finished;
+
+    uint16_t reserved = 0;
+    uint32_t reserved2 = 0;
+};
+
+static_assert(sizeof(TelemetryLogHeader) == 16,
+              "Telemetry log header must be packed");
+static_assert(sizeof(TelemetryRecordHeader) == 16,
+              "Telemetry record header must be packed");
+static_assert(sizeof(ShooterRecord) == 16, "ShooterRecord must be packed");
+static_assert(sizeof(FeederRecord) == 16, "FeederRecord must be packed");
+static_assert(sizeof(AutonomousRecord) == 16,
+              "AutonomousRecord must be packed");
+static_assert(sizeof(InputRecord) == 80, "InputRecord must be packed");
+static_assert(sizeof(OutputRecord) == 32, "OutputRecord must be packed");
+
+/**
+ * A named field of a record.
+ */
+template <typename Record, typename T>
+struct TelemetryField {
+    using Type = T;
+
+    const char* name;
+    T Record::*member;
+};
+
+template <typename Record, typename T>
+constexpr TelemetryField<Record, T> MakeTelemetryField(const char* name,
+                                                       T Record::*member) {
+    return {name, member};
+}
+
+/**
+ * Describes a record type's fields for decoding.
+ *
+ * Each specialization has a kName and a kFields tuple of TelemetryFields in
+ * declaration order. Reserved fields are left out. Field names include their
+ * units.
+ */
+template <typename Record>
+struct TelemetrySchema;
+
+template <>
+struct TelemetrySchema<ShooterRecord> {
+    static constexpr const char* kName = "Shooter";
+    static constexpr auto kFields = std::make_tuple(
+        MakeTelemetryField("reference_rpm", &ShooterRecord::reference),
+        MakeTelemetryField("angular_velocity_rpm",
+                           &ShooterRecord::angularVelocity),
+        MakeTelemetryField("voltage_v", &ShooterRecord::voltage),
+        MakeTelemetryField("enabled", &ShooterRecord::enabled),
+        MakeTelemetryField("at_reference", &ShooterRecord::atReference),
+        MakeTelemetryField("characterizing", &ShooterRecord::characterizing),
+        MakeTelemetryField("controller_type", &ShooterRecord::controllerType));
+};
+
+template <>
+struct TelemetrySchema<FeederRecord> {
+    static constexpr const char* kName = "Feeder";
+    static constexpr auto kFields = std::make_tuple(
+        MakeTelemetryField("num_shot", &FeederRecord::numShot),
+        MakeTelemetryField("total_to_shoot", &FeederRecord::totalToShoot),
+        MakeTelemetryField("lifetime_shot", &FeederRecord::lifetimeShot),
+        MakeTelemetryField("activated", &FeederRecord::activated),
+        MakeTelemetryField("feed_extended", &FeederRecord::feedExtended),
+        MakeTelemetryField("guard_lowered", &FeederRecord::guardLowered));
+};
+
+template <>
+struct TelemetrySchema<AutonomousRecord> {
+    static constexpr const char* kName = "Autonomous";
+    static constexpr auto kFields = std::make_tuple(
+        MakeTelemetryField("mode_index", &AutonomousRecord::modeIndex),
+        MakeTelemetryField("start_latency_s", &AutonomousRecord::startLatency),
+        MakeTelemetryField("event", &AutonomousRecord::event),
+        MakeTelemetryField("finished", &AutonomousRecord::finished));
+};
+
+template <>
+struct TelemetrySchema<InputRecord> {
+    static constexpr const char* kName = "Input";
+    static constexpr auto kFields = std::make_tuple(
+        MakeTelemetryField("drive_x", &InputRecord::driveX),
+        MakeTelemetryField("drive_y", &InputRecord::driveY),
+        MakeTelemetryField("drive_z", &InputRecord::driveZ),
+        MakeTelemetryField("shoot_x", &InputRecord::shootX),
+        MakeTelemetryField("shoot_y", &InputRecord::shootY),
+        MakeTelemetryField("shoot_z", &InputRecord::shootZ),
+        MakeTelemetryField("drive_buttons", &InputRecord::driveButtons),
+        MakeTelemetryField("shoot_buttons", &InputRecord::shootButtons),
+        MakeTelemetryField("fl_count", &InputRecord::flCount),
+        MakeTelemetryField("rl_count", &InputRecord::rlCount),
+        MakeTelemetryField("fr_count", &InputRecord::frCount),
+        MakeTelemetryField("rr_count", &InputRecord::rrCount),
+        MakeTelemetryField("fl_rate_in_per_s", &InputRecord::flRate),
+        MakeTelemetryField("rl_rate_in_per_s", &InputRecord::rlRate),
+        MakeTelemetryField("fr_rate_in_per_s", &InputRecord::frRate),
+        MakeTelemetryField("rr_rate_in_per_s", &InputRecord::rrRate),
+        MakeTelemetryField("gyro_angle_deg", &InputRecord::gyroAngle),
+        MakeTelemetryField("battery_voltage_v", &InputRecord::batteryVoltage),
+        MakeTelemetryField("enabled", &InputRecord::enabled),
+        MakeTelemetryField("autonomous", &InputRecord::autonomous),
+        MakeTelemetryField("test", &InputRecord::test));
+};
+
+template <>
+struct TelemetrySchema<OutputRecord> {
+    static constexpr const char* kName = "Output";
+    static constexpr auto kFields = std::make_tuple(
+        MakeTelemetryField("fl_output", &OutputRecord::flOutput),
+        MakeTelemetryField("rl_output", &OutputRecord::rlOutput),
+        MakeTelemetryField("fr_output", &OutputRecord::frOutput),
+        MakeTelemetryField("rr_output", &OutputRecord::rrOutput),
+        MakeTelemetryField("shooter_output", &OutputRecord::shooterOutput),
+        MakeTelemetryField("shooter_angle", &OutputRecord::shooterAngle),
+        MakeTelemetryField("climb_arms", &OutputRecord::climbArms),
+        MakeTelemetryField("feed_extended", &OutputRecord::feedExtended),
+        MakeTelemetryField("guard_lowered", &OutputRecord::guardLowered),
+        MakeTelemetryField("underglow", &OutputRecord::underglow));
+};
+
+/**
+ * Every record type, for code that handles all of them.
+ */
+using TelemetryRecordTypes = std::tuple<ShooterRecord, FeederRecord,
+                                        AutonomousRecord, InputRecord,
+                                        OutputRecord>;
+
+/**
+ * A record and the FPGA timestamp it was logged at.
+ */
+template <typename Record>
+struct TimestampedRecord {
+    // FPGA timestamp in microseconds
+    uint64_t timestamp;
+
+    Record record;
+};
+
+}  // namespace frc3512
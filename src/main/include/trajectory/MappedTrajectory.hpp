@@ -0,0 +1,89 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include <frc/geometry/Pose2d.h>
+#include <units/angle.h>
+#include <units/length.h>
+#include <units/time.h>
+
+#include "trajectory/TrajectoryFormat.hpp"
+
+namespace frc3512 {
+
+/**
+ * A view of one trajectory's samples in a memory-mapped trajectory file.
+ *
+ * It doesn't own the samples, so it's only valid while the TrajectoryCache it
+ * came from is loaded. It's cheap to copy.
+ */
+class MappedTrajectory {
+public:
+    /**
+     * Constructs a MappedTrajectory.
+     *
+     * @param samples Evenly spaced samples. There must be at least one.
+     * @param size    Number of samples.
+     * @param period  Time between samples.
+     */
+    MappedTrajectory(const TrajectorySample* samples, size_t size,
+                     units::second_t period)
+        : m_samples{samples}, m_size{size}, m_period{period} {}
+
+    /**
+     * Returns the sample nearest the given time since the start of the
+     * trajectory.
+     *
+     * Times before the start or after the end return the first or last
+     * sample. This is a constant-time index, so it's cheap to call every
+     * robot cycle.
+     *
+     * @param time Time since the start of the trajectory.
+     */
+    const TrajectorySample& Sample(units::second_t time) const {
+        double index = std::round((time / m_period).to<double>());
+        if (index <= 0.0) {
+            return m_samples[0];
+        }
+        if (index >= static_cast<double>(m_size - 1)) {
+            return m_samples[m_size - 1];
+        }
+        return m_samples[static_cast<size_t>(index)];
+    }
+
+    /**
+     * Returns the pose at the start of the trajectory.
+     */
+    frc::Pose2d GetInitialPose() const {
+        return frc::Pose2d{units::meter_t{m_samples[0].x},
+                           units::meter_t{m_samples[0].y},
+                           units::radian_t{m_samples[0].heading}};
+    }
+
+    /**
+     * Returns the time from the first sample to the last.
+     */
+    units::second_t GetTotalTime() const {
+        return m_period * static_cast<double>(m_size - 1);
+    }
+
+    /**
+     * Returns the time between samples.
+     */
+    units::second_t GetPeriod() const { return m_period; }
+
+    /**
+     * Returns the number of samples.
+     */
+    size_t Size() const { return m_size; }
+
+private:
+    const TrajectorySample* m_samples;
+    size_t m_size;
+    units::second_t m_period;
+};
+
+}  // namespace frc3512
@@ -0,0 +1,67 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <wpi/StringRef.h>
+
+#include "MappedFile.hpp"
+#include "trajectory/MappedTrajectory.hpp"
+#include "trajectory/TrajectoryFormat.hpp"
+
+namespace frc3512 {
+
+/**
+ * The trajectories generated by the trajectoryGenerator tool, memory-mapped
+ * from the deploy directory.
+ *
+ * Loading validates the file once and faults in every page, and on the robot
+ * locks them in RAM, so looking up a sample while following a trajectory never
+ * touches the disk.
+ */
+class TrajectoryCache {
+public:
+    TrajectoryCache() = default;
+
+    TrajectoryCache(const TrajectoryCache&) = delete;
+    TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+
+    /**
+     * Maps a trajectory file, replacing the trajectories loaded before.
+     *
+     * An error is printed if the file couldn't be mapped or isn't a valid
+     * trajectory file, and the cache is left empty.
+     *
+     * @param path Path of the file.
+     * @return True if the file was loaded.
+     */
+    bool Load(const std::string& path);
+
+    /**
+     * Returns the trajectory with the given name, or an empty optional if
+     * there isn't one.
+     *
+     * This searches the trajectory names, so it should be called once when
+     * starting to follow a trajectory rather than every cycle.
+     *
+     * @param name Name of the path file the trajectory came from, without the
+     *             extension.
+     */
+    std::optional<MappedTrajectory> Get(wpi::StringRef name) const;
+
+    /**
+     * Returns the number of trajectories loaded.
+     */
+    size_t Size() const;
+
+private:
+    std::unique_ptr<MappedFile> m_file;
+    std::vector<TrajectoryEntry> m_entries;
+    const TrajectorySample* m_samples = nullptr;
+};
+
+}  // namespace frc3512
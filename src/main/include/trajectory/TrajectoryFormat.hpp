@@ -0,0 +1,81 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Binary trajectory file format written by the trajectoryGenerator tool and
+ * memory-mapped by TrajectoryCache.
+ *
+ * A file is a TrajectoryFileHeader, then one TrajectoryEntry per trajectory,
+ * then every trajectory's samples back to back. Fields are stored in native
+ * byte order, which is little-endian on both the roboRIO and desktop
+ * platforms.
+ *
+ * Samples are spaced evenly in time, so the sample for a given time is found
+ * by indexing rather than searching or evaluating a spline.
+ */
+
+namespace frc3512 {
+
+struct TrajectoryFileHeader {
+    static constexpr std::array<char, 8> kMagic{
+        {'F', 'R', 'C', '3', '5', '1', '2', 'P'}};
+    static constexpr uint32_t kVersion = 1;
+
+    std::array<char, 8> magic = kMagic;
+    uint32_t version = kVersion;
+
+    uint32_t trajectoryCount;
+};
+
+struct TrajectoryEntry {
+    static constexpr size_t kMaxNameLength = 31;
+
+    // Null-terminated name of the path file the trajectory came from, without
+    // the extension
+    std::array<char, kMaxNameLength + 1> name;
+
+    // Index of the trajectory's first sample among all the file's samples
+    uint32_t firstSample;
+
+    uint32_t sampleCount;
+
+    // Time between samples in microseconds
+    uint32_t period;
+
+    uint32_t reserved = 0;
+};
+
+/**
+ * The robot's reference state at one point in time along a trajectory.
+ *
+ * Positions and velocities are field-relative. Headings are counterclockwise
+ * positive, matching MecanumPoseEstimator.
+ */
+struct TrajectorySample {
+    // Position in meters
+    float x;
+    float y;
+
+    // Heading in radians
+    float heading;
+
+    // Velocity in meters per second
+    float vx;
+    float vy;
+
+    // Angular velocity in radians per second
+    float omega;
+};
+
+static_assert(sizeof(TrajectoryFileHeader) == 16,
+              "TrajectoryFileHeader must be packed");
+static_assert(sizeof(TrajectoryEntry) == 48, "TrajectoryEntry must be packed");
+static_assert(sizeof(TrajectorySample) == 24,
+              "TrajectorySample must be packed");
+
+}  // namespace frc3512
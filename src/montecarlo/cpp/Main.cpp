@@ -0,0 +1,343 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Runs every autonomous mode many times in simulation with randomized sensor
+// noise, battery condition, and wheel slip, then reports the distributions of
+// the final pose, discs fired, and time to the first shot.
+//
+// Usage: autonMonteCarlo [--runs N] [--jobs N] [--seed N]
+//
+// The simulated HAL is global to a process, so the runs are split across
+// worker processes (this executable started with --worker) that each run their
+// share sequentially and print one result line per run. Every run's
+// parameters are derived from the seed and the run index, so results don't
+// depend on the number of jobs.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+#include <frc2/Timer.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/impedance.h>
+#include <units/length.h>
+#include <units/voltage.h>
+
+#include "MatchSimulator.hpp"
+#include "Robot.hpp"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace {
+
+constexpr int kDefaultRuns = 1000;
+constexpr uint32_t kDefaultSeed = 3512;
+
+// Marks result lines in a worker's output, which also contains the robot's
+// own prints
+constexpr char kResultTag[] = "RESULT";
+
+struct RunParameters {
+    units::volt_t batteryVoltage;
+    units::ohm_t batteryResistance;
+    double wheelSlip;
+    units::inch_t encoderNoise;
+    units::degrees_per_second_t gyroRateNoise;
+    units::revolutions_per_minute_t flywheelNoise;
+    uint32_t noiseSeed;
+};
+
+struct RunResult {
+    std::string mode;
+    int run = 0;
+
+    // Final pose in inches and degrees
+    double x = 0.0;
+    double y = 0.0;
+    double heading = 0.0;
+
+    unsigned int discs = 0;
+
+    // Seconds from the start of autonomous, or negative if no disc was fired
+    double firstShot = -1.0;
+};
+
+RunParameters DrawParameters(uint32_t seed, int run) {
+    std::seed_seq seq{seed, static_cast<uint32_t>(run)};
+    std::mt19937 generator{seq};
+
+    auto uniform = [&](double min, double max) {
+        return std::uniform_real_distribution<double>{min, max}(generator);
+    };
+
+    RunParameters params;
+    params.batteryVoltage = units::volt_t{uniform(12.0, 13.0)};
+    params.batteryResistance = units::ohm_t{uniform(0.012, 0.03)};
+    params.wheelSlip = uniform(0.0, 0.1);
+    params.encoderNoise = units::inch_t{uniform(0.0, 0.1)};
+    params.gyroRateNoise = units::degrees_per_second_t{uniform(0.0, 0.5)};
+    params.flywheelNoise = units::revolutions_per_minute_t{uniform(0.0, 50.0)};
+    params.noiseSeed = generator();
+    return params;
+}
+
+RunResult RunAutonomous(const std::string& mode, int run, uint32_t seed) {
+    auto params = DrawParameters(seed, run);
+
+    frc3512::MatchSimulator simulator;
+    Robot& robot = simulator.GetRobot();
+    robot.GetAutonomousChooser().SelectAutonomous(mode);
+    robot.SetSimulatedBattery(params.batteryVoltage, params.batteryResistance);
+    robot.GetDriveSim().SetWheelSlip(params.wheelSlip);
+    robot.GetDriveSim().SetMeasurementNoise(
+        params.encoderNoise, params.gyroRateNoise, params.noiseSeed);
+    robot.GetShooter().SetSimulatedMeasurementNoise(params.flywheelNoise,
+                                                    params.noiseSeed + 1);
+
+    simulator.Run(frc3512::MatchSimulator::Mode::kDisabled, 0.1_s);
+
+    RunResult result;
+    result.mode = mode;
+    result.run = run;
+
+    auto start = frc2::Timer::GetFPGATimestamp();
+    simulator.Run(frc3512::MatchSimulator::Mode::kAutonomous,
+                  frc3512::MatchSimulator::kAutonomousDuration, [&] {
+                      if (result.firstShot < 0.0 &&
+                          robot.GetFeeder().GetTotalShot() > 0) {
+                          result.firstShot =
+                              (frc2::Timer::GetFPGATimestamp() - start)
+                                  .to<double>();
+                      }
+                  });
+
+    auto pose = robot.GetDriveSim().GetPose();
+    result.x = units::inch_t{pose.X()}.to<double>();
+    result.y = units::inch_t{pose.Y()}.to<double>();
+    result.heading = pose.Rotation().Degrees().to<double>();
+    result.discs = robot.GetFeeder().GetTotalShot();
+
+    return result;
+}
+
+int RunWorker(int firstRun, int runCount, uint32_t seed) {
+    std::vector<std::string> names;
+    {
+        frc3512::MatchSimulator simulator;
+        names =
+            simulator.GetRobot().GetAutonomousChooser().GetAutonomousNames();
+    }
+
+    for (int run = firstRun; run < firstRun + runCount; ++run) {
+        for (const auto& name : names) {
+            auto result = RunAutonomous(name, run, seed);
+            fmt::print("{},{},{},{},{},{},{},{}\n", kResultTag, result.mode,
+                       result.run, result.x, result.y, result.heading,
+                       result.discs, result.firstShot);
+        }
+    }
+    std::fflush(stdout);
+
+    return 0;
+}
+
+bool ParseResult(const std::string& line, RunResult& result) {
+    std::stringstream stream{line};
+    std::vector<std::string> fields;
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        fields.emplace_back(field);
+    }
+
+    if (fields.size() != 8 || fields[0] != kResultTag) {
+        return false;
+    }
+
+    result.mode = fields[1];
+    result.run = std::stoi(fields[2]);
+    result.x = std::stod(fields[3]);
+    result.y = std::stod(fields[4]);
+    result.heading = std::stod(fields[5]);
+    result.discs = static_cast<unsigned int>(std::stoul(fields[6]));
+    result.firstShot = std::stod(fields[7]);
+    return true;
+}
+
+/**
+ * Starts a worker process and collects its results.
+ *
+ * @return False if the worker couldn't be started or exited with an error.
+ */
+bool RunWorkerProcess(const std::string& executable, int firstRun,
+                      int runCount, uint32_t seed,
+                      std::vector<RunResult>& results) {
+    auto command = fmt::format("\"{}\" --worker {} {} {}", executable,
+                               firstRun, runCount, seed);
+    std::FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) {
+        return false;
+    }
+
+    char buffer[1024];
+    while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        std::string line{buffer};
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+            line.pop_back();
+        }
+
+        RunResult result;
+        if (ParseResult(line, result)) {
+            results.emplace_back(result);
+        }
+    }
+
+    return pclose(pipe) == 0;
+}
+
+double Percentile(std::vector<double> values, double percentile) {
+    if (values.empty()) {
+        return NAN;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(
+        std::round(percentile / 100.0 * (values.size() - 1)));
+    return values[index];
+}
+
+void PrintDistribution(const char* name, const std::vector<double>& values) {
+    double mean = 0.0;
+    for (double value : values) {
+        mean += value;
+    }
+    mean /= values.size();
+
+    double variance = 0.0;
+    for (double value : values) {
+        variance += (value - mean) * (value - mean);
+    }
+    variance /= values.size();
+
+    fmt::print(
+        "  {:<16} mean {:8.2f}  std {:7.2f}  p5 {:8.2f}  p50 {:8.2f}  p95 "
+        "{:8.2f}\n",
+        name, mean, std::sqrt(variance), Percentile(values, 5.0),
+        Percentile(values, 50.0), Percentile(values, 95.0));
+}
+
+void PrintReport(const std::vector<RunResult>& results) {
+    std::map<std::string, std::vector<RunResult>> byMode;
+    for (const auto& result : results) {
+        byMode[result.mode].emplace_back(result);
+    }
+
+    for (const auto& [mode, modeResults] : byMode) {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> heading;
+        std::vector<double> firstShot;
+        std::map<unsigned int, int> discs;
+        for (const auto& result : modeResults) {
+            x.emplace_back(result.x);
+            y.emplace_back(result.y);
+            heading.emplace_back(result.heading);
+            if (result.firstShot >= 0.0) {
+                firstShot.emplace_back(result.firstShot);
+            }
+            ++discs[result.discs];
+        }
+
+        fmt::print("{} ({} runs)\n", mode, modeResults.size());
+        PrintDistribution("x (in)", x);
+        PrintDistribution("y (in)", y);
+        PrintDistribution("heading (deg)", heading);
+        if (!firstShot.empty()) {
+            PrintDistribution("first shot (s)", firstShot);
+        }
+        fmt::print("  {:<16}", "discs fired");
+        for (const auto& [count, runs] : discs) {
+            fmt::print(" {}: {}", count, runs);
+        }
+        fmt::print("\n");
+    }
+}
+
+int PrintUsage(const char* program) {
+    fmt::print(stderr, "usage: {} [--runs N] [--jobs N] [--seed N]\n", program);
+    return 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int runs = kDefaultRuns;
+    int jobs = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t seed = kDefaultSeed;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--worker" && i + 3 < argc) {
+            return RunWorker(std::atoi(argv[i + 1]), std::atoi(argv[i + 2]),
+                             static_cast<uint32_t>(std::stoul(argv[i + 3])));
+        } else if (arg == "--runs" && i + 1 < argc) {
+            runs = std::atoi(argv[++i]);
+            if (runs < 1) {
+                return PrintUsage(argv[0]);
+            }
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else {
+            return PrintUsage(argv[0]);
+        }
+    }
+    jobs = std::min(jobs, runs);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<RunResult>> workerResults(jobs);
+    std::vector<char> workerSucceeded(jobs, false);
+    std::vector<std::thread> threads;
+    for (int job = 0; job < jobs; ++job) {
+        int firstRun = runs * job / jobs;
+        int runCount = runs * (job + 1) / jobs - firstRun;
+        threads.emplace_back([&, job, firstRun, runCount] {
+            workerSucceeded[job] = RunWorkerProcess(
+                argv[0], firstRun, runCount, seed, workerResults[job]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::vector<RunResult> results;
+    for (int job = 0; job < jobs; ++job) {
+        if (!workerSucceeded[job]) {
+            fmt::print(stderr, "error: worker {} failed\n", job);
+            return 1;
+        }
+        results.insert(results.end(), workerResults[job].begin(),
+                       workerResults[job].end());
+    }
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    fmt::print("{} simulated autonomous runs on {} jobs in {:.1f} s ({:.1f} "
+               "runs/s)\n\n",
+               results.size(), jobs, seconds, results.size() / seconds);
+    PrintReport(results);
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Replays a telemetry log recorded by the robot through the robot code in
+// simulation and reports where the actuator outputs differ from the logged
+// ones.
+//
+// Usage: logReplay <log>
+//
+// Exits with 0 if every output matched and 1 if any differed, so it can be
+// used with git bisect run to find the commit that changed the robot's
+// behavior in a match. Exits with 2 if the log can't be read.
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fmt/core.h>
+#include <hal/HAL.h>
+
+#include "LogReplayer.hpp"
+#include "MappedFile.hpp"
+#include "TelemetryDecoder.hpp"
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        fmt::print(stderr, "usage: {} <log>\n", argv[0]);
+        return 2;
+    }
+    std::string logPath = argv[1];
+
+    frc3512::ReplayLog log;
+    try {
+        MappedFile file{logPath};
+        TelemetryDecoder decoder{file.Data(), file.Size()};
+        log.inputs = decoder.GetRecords<frc3512::InputRecord>();
+        log.outputs = decoder.GetRecords<frc3512::OutputRecord>();
+        log.shooter = decoder.GetRecords<frc3512::ShooterRecord>();
+        log.autonomous = decoder.GetRecords<frc3512::AutonomousRecord>();
+    } catch (const std::system_error& e) {
+        fmt::print(stderr, "error: {}\n", e.what());
+        return 2;
+    } catch (const std::runtime_error& e) {
+        fmt::print(stderr, "error: {}: {}\n", logPath, e.what());
+        return 2;
+    }
+
+    if (log.inputs.empty()) {
+        fmt::print(stderr, "error: {}: no robot loop inputs were logged\n",
+                   logPath);
+        return 2;
+    }
+
+    HAL_Initialize(500, 0);
+
+    uint64_t firstTimestamp = log.inputs.front().timestamp;
+    double logSeconds = (log.inputs.back().timestamp - firstTimestamp) / 1e6;
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = frc3512::LogReplayer{std::move(log)}.Run();
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    fmt::print("Replayed {} robot loops ({:.1f} s of log) in {:.2f} s, {:.0f}x "
+               "real time\n",
+               result.loops, logSeconds, seconds, logSeconds / seconds);
+    if (result.compared < result.loops) {
+        fmt::print("{} loops had no logged outputs to compare against\n",
+                   result.loops - result.compared);
+    }
+
+    if (result.Matches()) {
+        fmt::print("All outputs matched the log\n");
+        return 0;
+    }
+
+    // Times are relative to the first logged loop
+    fmt::print("{:<16} {:>10} {:>10} {:>10} {:>10} {:>10}\n", "Output",
+               "Loops", "Max error", "First (s)", "Logged", "Replayed");
+    for (const auto& diff : result.diffs) {
+        fmt::print("{:<16} {:>10} {:>10.4f} {:>10.3f} {:>10.4f} {:>10.4f}\n",
+                   diff.name, diff.mismatches, diff.maxError,
+                   (diff.firstTimestamp - firstTimestamp) / 1e6,
+                   diff.firstLogged, diff.firstReplayed);
+    }
+
+    return 1;
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "LogReplayer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+#include <frc2/Timer.h>
+#include <units/angular_velocity.h>
+#include <units/time.h>
+
+#include "MatchSimulator.hpp"
+#include "subsystems/Shooter.hpp"
+
+namespace frc3512 {
+
+namespace {
+
+uint64_t ToMicroseconds(units::second_t time) {
+    return static_cast<uint64_t>(
+        std::llround(units::microsecond_t{time}.to<double>()));
+}
+
+/**
+ * Returns the log timestamp that the simulated clock's zero corresponds to.
+ *
+ * The flywheel controller's Notifier starts with the clock, so the offset
+ * puts its updates on the logged ones. The first input is at most one
+ * controller period after it.
+ *
+ * @param log    Records to replay. There must be at least one input.
+ * @param period Flywheel controller period in microseconds.
+ */
+uint64_t GetLogOrigin(const ReplayLog& log, int64_t period) {
+    auto first = static_cast<int64_t>(log.inputs.front().timestamp);
+
+    int64_t offset = 0;
+    if (!log.shooter.empty()) {
+        auto update = static_cast<int64_t>(log.shooter.front().timestamp);
+        offset = ((update - first) % period + period) % period;
+    }
+
+    int64_t origin = first + offset - period;
+    return static_cast<uint64_t>(std::max<int64_t>(origin, 0));
+}
+
+/**
+ * Adds a difference between a logged and replayed OutputRecord field to its
+ * running totals.
+ */
+template <typename Field>
+void CompareField(const Field& field, uint64_t timestamp,
+                  const OutputRecord& logged, const OutputRecord& replayed,
+                  ReplayFieldDiff& diff) {
+    auto loggedValue = static_cast<double>(logged.*field.member);
+    auto replayedValue = static_cast<double>(replayed.*field.member);
+    double error = std::abs(loggedValue - replayedValue);
+    if (error <= LogReplayer::kTolerance) {
+        return;
+    }
+
+    if (diff.mismatches == 0) {
+        diff.firstTimestamp = timestamp;
+        diff.firstLogged = loggedValue;
+        diff.firstReplayed = replayedValue;
+    }
+    ++diff.mismatches;
+    diff.maxError = std::max(diff.maxError, error);
+}
+
+}  // namespace
+
+bool ReplayResult::Matches() const { return diffs.empty(); }
+
+LogReplayer::LogReplayer(ReplayLog log) : m_log{std::move(log)} {}
+
+ReplayResult LogReplayer::Run() {
+    ReplayResult result;
+
+    const auto& inputs = m_log.inputs;
+    const auto& outputs = m_log.outputs;
+    const auto& shooter = m_log.shooter;
+    const auto& autonomous = m_log.autonomous;
+    if (inputs.empty()) {
+        return result;
+    }
+
+    // Running totals for each OutputRecord field
+    const auto& schema = TelemetrySchema<OutputRecord>::kFields;
+    std::vector<ReplayFieldDiff> diffs;
+    std::apply(
+        [&](const auto&... field) {
+            ((diffs.emplace_back().name = field.name), ...);
+        },
+        schema);
+
+    auto period = static_cast<int64_t>(
+        ToMicroseconds(Shooter::kDefaultControllerPeriod));
+    uint64_t origin = GetLogOrigin(m_log, period);
+
+    // Next ShooterRecord and the measurement of the last one replayed. Only
+    // the controller's Notifier uses these.
+    size_t shooterIndex = 0;
+    double angularVelocity = 0.0;
+
+    // Declared after the state its hooks use so the robot is destroyed first
+    MatchSimulator simulator;
+    auto& robot = simulator.GetRobot();
+    robot.SetSimulatedPhysicsEnabled(false);
+    robot.GetShooter().SetSimulatedMeasurementSource([&] {
+        // Records are logged a little after their update runs, so take the
+        // last one logged within half a period of this update
+        uint64_t now =
+            origin + ToMicroseconds(frc2::Timer::GetFPGATimestamp());
+        while (shooterIndex < shooter.size() &&
+               shooter[shooterIndex].timestamp <
+                   now + static_cast<uint64_t>(period / 2)) {
+            angularVelocity = shooter[shooterIndex].record.angularVelocity;
+            ++shooterIndex;
+        }
+        return units::revolutions_per_minute_t{angularVelocity};
+    });
+
+    size_t outputIndex = 0;
+    size_t autonomousIndex = 0;
+    bool wasAutonomous = false;
+    uint64_t now = origin;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const auto& input = inputs[i];
+
+        // Select the mode the robot started after the previous iteration
+        bool isAutonomous = input.record.enabled && input.record.autonomous;
+        if (isAutonomous && !wasAutonomous) {
+            uint64_t previous = i > 0 ? inputs[i - 1].timestamp : 0;
+            while (autonomousIndex < autonomous.size() &&
+                   (autonomous[autonomousIndex].timestamp < previous ||
+                    autonomous[autonomousIndex].record.event !=
+                        AutonomousRecord::kStarted)) {
+                ++autonomousIndex;
+            }
+            if (autonomousIndex < autonomous.size()) {
+                robot.GetAutonomousChooser().SelectAutonomous(size_t{
+                    autonomous[autonomousIndex].record.modeIndex});
+            }
+        }
+        wasAutonomous = isAutonomous;
+
+        robot.SetSimulatedInputs(input.record);
+        simulator.Step(units::microsecond_t{
+            static_cast<double>(input.timestamp - now)});
+        now = input.timestamp;
+        ++result.loops;
+
+        // The outputs are logged right after the inputs in the same iteration
+        uint64_t next = i + 1 < inputs.size()
+                            ? inputs[i + 1].timestamp
+                            : std::numeric_limits<uint64_t>::max();
+        while (outputIndex < outputs.size() &&
+               outputs[outputIndex].timestamp < input.timestamp) {
+            ++outputIndex;
+        }
+        if (outputIndex == outputs.size() ||
+            outputs[outputIndex].timestamp >= next) {
+            continue;
+        }
+
+        const auto& logged = outputs[outputIndex].record;
+        auto replayed = robot.GetOutputs();
+        size_t field = 0;
+        std::apply(
+            [&](const auto&... fields) {
+                (CompareField(fields, input.timestamp, logged, replayed,
+                              diffs[field++]),
+                 ...);
+            },
+            schema);
+        ++outputIndex;
+        ++result.compared;
+    }
+
+    for (auto& diff : diffs) {
+        if (diff.mismatches > 0) {
+            result.diffs.emplace_back(std::move(diff));
+        }
+    }
+
+    return result;
+}
+
+}  // namespace frc3512
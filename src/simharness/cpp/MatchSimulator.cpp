@@ -0,0 +1,138 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "MatchSimulator.hpp"
+
+#include <cmath>
+
+#include <frc/simulation/AnalogGyroSim.h>
+#include <frc/simulation/DriverStationSim.h>
+#include <frc/simulation/EncoderSim.h>
+#include <frc/simulation/PCMSim.h>
+#include <frc/simulation/PWMSim.h>
+#include <frc/simulation/RoboRioSim.h>
+#include <frc/simulation/SimHooks.h>
+#include <frc2/Timer.h>
+#include <hal/Ports.h>
+#include <networktables/NetworkTableInstance.h>
+
+namespace frc3512 {
+
+/**
+ * Exposes the robot loop so it can be run one iteration at a time instead of
+ * from TimedRobot's Notifier.
+ */
+class MatchSimulator::SimulatedRobot : public Robot {
+public:
+    using Robot::LoopFunc;
+};
+
+namespace {
+
+void ResetSimData() {
+    for (int i = 0; i < HAL_GetNumPWMChannels(); ++i) {
+        frc::sim::PWMSim{i}.ResetData();
+    }
+    for (int i = 0; i < HAL_GetNumEncoders(); ++i) {
+        frc::sim::EncoderSim::CreateForIndex(i).ResetData();
+    }
+    for (int i = 0; i < HAL_GetNumAccumulators(); ++i) {
+        frc::sim::AnalogGyroSim{i}.ResetData();
+    }
+    frc::sim::PCMSim{}.ResetData();
+    frc::sim::DriverStationSim::ResetData();
+    frc::sim::RoboRioSim::ResetData();
+
+    // Keep the previous robot's dashboard selection from reaching the new
+    // robot's listeners
+    nt::NetworkTableInstance::GetDefault().DeleteAllEntries();
+}
+
+}  // namespace
+
+bool MatchSnapshot::operator==(const MatchSnapshot& rhs) const {
+    return timestamp == rhs.timestamp && pwmSpeeds == rhs.pwmSpeeds &&
+           encoderCounts == rhs.encoderCounts &&
+           gyroAngles == rhs.gyroAngles && solenoids == rhs.solenoids;
+}
+
+bool MatchSnapshot::operator!=(const MatchSnapshot& rhs) const {
+    return !(*this == rhs);
+}
+
+MatchSimulator::MatchSimulator() {
+    ResetSimData();
+
+    // Pausing first makes the restarted clock read exactly zero
+    frc::sim::PauseTiming();
+    frc::sim::RestartTiming();
+
+    frc::sim::DriverStationSim::SetDsAttached(true);
+    frc::sim::DriverStationSim::SetEnabled(false);
+    frc::sim::DriverStationSim::NotifyNewData();
+
+    m_robot = std::make_unique<SimulatedRobot>();
+    m_robot->RobotInit();
+    m_robot->SimulationInit();
+}
+
+MatchSimulator::~MatchSimulator() {
+    m_robot.reset();
+    frc::sim::ResumeTiming();
+}
+
+Robot& MatchSimulator::GetRobot() { return *m_robot; }
+
+void MatchSimulator::Run(Mode mode, units::second_t duration,
+                         std::function<void()> callback) {
+    frc::sim::DriverStationSim::SetEnabled(mode != Mode::kDisabled);
+    frc::sim::DriverStationSim::SetAutonomous(mode == Mode::kAutonomous);
+    frc::sim::DriverStationSim::SetTest(false);
+    frc::sim::DriverStationSim::NotifyNewData();
+
+    int steps = static_cast<int>(std::round(duration / kLoopPeriod));
+    for (int i = 0; i < steps; ++i) {
+        Step(kLoopPeriod);
+
+        if (callback) {
+            callback();
+        }
+    }
+}
+
+void MatchSimulator::Step(units::second_t dt) {
+    // Runs every Notifier due within the period and waits for them to finish
+    // before returning
+    frc::sim::StepTiming(dt);
+
+    m_robot->LoopFunc();
+    m_snapshots.emplace_back(TakeSnapshot());
+}
+
+const std::vector<MatchSnapshot>& MatchSimulator::GetSnapshots() const {
+    return m_snapshots;
+}
+
+MatchSnapshot MatchSimulator::TakeSnapshot() const {
+    MatchSnapshot snapshot;
+    snapshot.timestamp = frc2::Timer::GetFPGATimestamp();
+
+    for (int i = 0; i < HAL_GetNumPWMChannels(); ++i) {
+        snapshot.pwmSpeeds.emplace_back(frc::sim::PWMSim{i}.GetSpeed());
+    }
+    for (int i = 0; i < HAL_GetNumEncoders(); ++i) {
+        snapshot.encoderCounts.emplace_back(
+            frc::sim::EncoderSim::CreateForIndex(i).GetCount());
+    }
+    for (int i = 0; i < HAL_GetNumAccumulators(); ++i) {
+        snapshot.gyroAngles.emplace_back(frc::sim::AnalogGyroSim{i}.GetAngle());
+    }
+
+    frc::sim::PCMSim pcm;
+    for (int i = 0; i < HAL_GetNumSolenoidChannels(); ++i) {
+        snapshot.solenoids.emplace_back(pcm.GetSolenoidOutput(i));
+    }
+
+    return snapshot;
+}
+
+}  // namespace frc3512
@@ -0,0 +1,114 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "telemetry/TelemetryRecords.hpp"
+
+namespace frc3512 {
+
+/**
+ * Records from a telemetry log that LogReplayer uses, each in the order they
+ * were logged.
+ */
+struct ReplayLog {
+    std::vector<TimestampedRecord<InputRecord>> inputs;
+    std::vector<TimestampedRecord<OutputRecord>> outputs;
+    std::vector<TimestampedRecord<ShooterRecord>> shooter;
+    std::vector<TimestampedRecord<AutonomousRecord>> autonomous;
+};
+
+/**
+ * How one OutputRecord field differed between a log and its replay.
+ */
+struct ReplayFieldDiff {
+    // Field name from the OutputRecord schema
+    std::string name;
+
+    // Number of robot loops where the field differed
+    size_t mismatches = 0;
+
+    // Largest absolute difference
+    double maxError = 0.0;
+
+    // Log timestamp in microseconds of the first difference, and the values
+    // there
+    uint64_t firstTimestamp = 0;
+    double firstLogged = 0.0;
+    double firstReplayed = 0.0;
+};
+
+/**
+ * Result of replaying a log.
+ */
+struct ReplayResult {
+    // Robot loop iterations replayed
+    size_t loops = 0;
+
+    // Iterations that had a logged OutputRecord to compare against
+    size_t compared = 0;
+
+    // Fields that differed in at least one iteration, in OutputRecord order
+    std::vector<ReplayFieldDiff> diffs;
+
+    /**
+     * Returns true if every compared output matched.
+     */
+    bool Matches() const;
+};
+
+/**
+ * Replays a telemetry log through Robot in simulation and compares its
+ * actuator outputs to the logged ones.
+ *
+ * Each InputRecord is one robot loop iteration. The simulated clock is
+ * advanced to the input's timestamp, the inputs are set with
+ * Robot::SetSimulatedInputs(), and the iteration is run with
+ * MatchSimulator::Step(). The drivetrain and battery models are disabled so
+ * the logged sensor readings stand. Every flywheel controller update gets the
+ * measurement logged in its ShooterRecord, and the clock is offset so the
+ * controller's Notifier fires when it did on the robot. Before autonomous
+ * mode starts, the mode that the log's AutonomousRecords say was run is
+ * selected.
+ *
+ * After each iteration, Robot::GetOutputs() is compared to the OutputRecord
+ * logged in the same iteration. Nothing waits on wall time, so a match replays
+ * in a small fraction of its length and the same log always produces the same
+ * outputs.
+ *
+ * Inputs are only logged once per robot loop, so a button pressed and
+ * released between two loops is lost, and the sensors are logged a little
+ * after the robot code read them. A log from the robot may differ slightly
+ * from its replay for these reasons. Replaying the same log on two builds
+ * shows where their behavior differs.
+ *
+ * This runs a MatchSimulator, so it can't be used while another one exists.
+ */
+class LogReplayer {
+public:
+    // Largest difference between logged and replayed outputs that's still a
+    // match. Inputs are logged as floats, so outputs computed from them can
+    // differ by rounding.
+    static constexpr double kTolerance = 1e-4;
+
+    /**
+     * Constructs a LogReplayer.
+     *
+     * @param log Records to replay.
+     */
+    explicit LogReplayer(ReplayLog log);
+
+    /**
+     * Replays every logged robot loop iteration.
+     */
+    ReplayResult Run();
+
+private:
+    ReplayLog m_log;
+};
+
+}  // namespace frc3512
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <units/time.h>
+
+#include "Robot.hpp"
+
+namespace frc3512 {
+
+/**
+ * Outputs and sensor readings of the simulated robot at the end of a robot
+ * loop iteration.
+ *
+ * Every channel the HAL simulates is captured, so two snapshots compare equal
+ * only if the runs produced bit-for-bit identical results.
+ */
+struct MatchSnapshot {
+    units::second_t timestamp;
+    std::vector<double> pwmSpeeds;
+    std::vector<int> encoderCounts;
+    std::vector<double> gyroAngles;
+    std::vector<bool> solenoids;
+
+    bool operator==(const MatchSnapshot& rhs) const;
+    bool operator!=(const MatchSnapshot& rhs) const;
+};
+
+/**
+ * Runs Robot against the simulated HAL faster than real time.
+ *
+ * The HAL sim clock is paused and restarted at zero, then advanced in robot
+ * loop periods. Each step first runs the Notifiers that are due, like the
+ * shooter controller, then runs one iteration of the robot loop on the calling
+ * thread. Nothing depends on wall time or thread scheduling, so the same
+ * sequence of modes always produces the same results.
+ *
+ * Simulated HAL state is reset on construction, and only one MatchSimulator
+ * may exist at a time.
+ */
+class MatchSimulator {
+public:
+    enum class Mode { kDisabled, kAutonomous, kTeleop };
+
+    static constexpr units::second_t kLoopPeriod = 20_ms;
+    static constexpr units::second_t kAutonomousDuration = 15_s;
+    static constexpr units::second_t kTeleopDuration = 135_s;
+
+    /**
+     * Resets the simulated HAL, pauses its clock, and constructs the robot.
+     */
+    MatchSimulator();
+
+    /**
+     * Destroys the robot and resumes the HAL sim clock.
+     */
+    ~MatchSimulator();
+
+    MatchSimulator(const MatchSimulator&) = delete;
+    MatchSimulator& operator=(const MatchSimulator&) = delete;
+
+    /**
+     * Returns the simulated robot.
+     */
+    Robot& GetRobot();
+
+    /**
+     * Runs the robot in the given mode for the given amount of simulated time.
+     *
+     * The duration is rounded to a whole number of robot loop periods.
+     *
+     * @param mode     Driver station mode.
+     * @param duration Simulated time to run for.
+     * @param callback Optional function called after each robot loop
+     *                 iteration.
+     */
+    void Run(Mode mode, units::second_t duration,
+             std::function<void()> callback = nullptr);
+
+    /**
+     * Advances the simulated clock by the given time, then runs one iteration
+     * of the robot loop.
+     *
+     * The driver station mode and inputs are left as they are, so the caller
+     * can set them through the sim hooks first.
+     *
+     * @param dt Simulated time to advance by.
+     */
+    void Step(units::second_t dt);
+
+    /**
+     * Returns a snapshot for every robot loop iteration run so far.
+     */
+    const std::vector<MatchSnapshot>& GetSnapshots() const;
+
+private:
+    class SimulatedRobot;
+
+    std::unique_ptr<SimulatedRobot> m_robot;
+    std::vector<MatchSnapshot> m_snapshots;
+
+    MatchSnapshot TakeSnapshot() const;
+};
+
+}  // namespace frc3512
@@ -0,0 +1,101 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "FlywheelFitter.hpp"
+
+#include <cmath>
+
+#include <Eigen/Cholesky>
+
+namespace {
+
+int Sign(double x) { return (0.0 < x) - (x < 0.0); }
+
+}  // namespace
+
+void FlywheelFitter::AddSample(double timestamp, double voltage,
+                               double angularVelocity) {
+    if (m_hasPrevious) {
+        double dt = timestamp - m_prevTimestamp;
+
+        // Skip the stationary flywheel before and after the script since it
+        // doesn't carry any information about the model
+        bool stationary = m_prevVoltage == 0.0 && m_prevVelocity == 0.0;
+
+        if (dt > 0.0 && dt <= kMaxPeriod && !stationary) {
+            Eigen::Vector3d x{m_prevVelocity, m_prevVoltage,
+                              static_cast<double>(Sign(m_prevVelocity))};
+            m_xtx += x * x.transpose();
+            m_xty += x * angularVelocity;
+            m_yty += angularVelocity * angularVelocity;
+            m_ySum += angularVelocity;
+            m_dtSum += dt;
+            ++m_count;
+        }
+    }
+
+    m_prevTimestamp = timestamp;
+    m_prevVoltage = voltage;
+    m_prevVelocity = angularVelocity;
+    m_hasPrevious = true;
+}
+
+FlywheelFit FlywheelFitter::Fit() const {
+    FlywheelFit fit;
+    if (m_count < 3) {
+        return fit;
+    }
+
+    auto ldlt = m_xtx.ldlt();
+    if (ldlt.info() != Eigen::Success || !ldlt.isPositive()) {
+        return fit;
+    }
+    Eigen::Vector3d beta = ldlt.solve(m_xty);
+    double a = beta(0);
+    double b = beta(1);
+    double c = beta(2);
+
+    // A flywheel decays toward zero on its own, so 0 < a < 1 and b > 0
+    if (!(a > 0.0 && a < 1.0 && b > 0.0)) {
+        return fit;
+    }
+
+    fit.dt = m_dtSum / m_count;
+
+    // ω[k+1] = a ω[k] + b V[k] + c sgn(ω[k]) is the zero-order hold
+    // discretization of dω/dt = A ω + B V + C sgn(ω), where a = exp(A dt),
+    // b = (a - 1) B / A, and c = (a - 1) C / A. Then kA = 1/B, kV = -A/B, and
+    // kS = -C/B.
+    double A = std::log(a) / fit.dt;
+    double B = b * A / (a - 1.0);
+    fit.kA = 1.0 / B;
+    fit.kV = -A / B;
+    fit.kS = -c / b;
+
+    double sse = m_yty - 2.0 * beta.dot(m_xty) + beta.dot(m_xtx * beta);
+    double sst = m_yty - m_ySum * m_ySum / m_count;
+    fit.rSquared = sst > 0.0 ? 1.0 - sse / sst : 0.0;
+    fit.samples = m_count;
+
+    return fit;
+}
+
+double ComputeLQRGain(const FlywheelFit& fit, double dt,
+                      double velocityTolerance, double maxVoltage) {
+    // Discretize the model at the controller period
+    double A = -fit.kV / fit.kA;
+    double B = 1.0 / fit.kA;
+    double a = std::exp(A * dt);
+    double b = (a - 1.0) * B / A;
+
+    // Bryson's rule
+    double q = 1.0 / (velocityTolerance * velocityTolerance);
+    double r = 1.0 / (maxVoltage * maxVoltage);
+
+    // The scalar DARE p = a²p - a²b²p²/(r + b²p) + q rearranges to
+    // b²p² + (r - qb² - a²r)p - qr = 0, whose positive root is the solution
+    double linear = r - q * b * b - a * a * r;
+    double p = (-linear + std::sqrt(linear * linear + 4.0 * b * b * q * r)) /
+               (2.0 * b * b);
+
+    return a * b * p / (r + b * b * p);
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Fits the flywheel model to a log recorded by Shooter's characterization mode
+// and writes the constants Shooter loads at startup.
+//
+// Usage: flywheelSysId <log> [output JSON]
+
+#include <fcntl.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <fmt/core.h>
+#include <fmt/os.h>
+#include <wpi/math>
+
+#include "FlywheelCharacterizationLog.hpp"
+#include "FlywheelFitter.hpp"
+
+namespace {
+
+// Controller parameters used for the recommended gains. These match Shooter's
+// controller period and StateSpaceFlywheelController's LQR weights.
+constexpr double kControllerPeriod = 0.005;
+constexpr double kVelocityTolerance = 100.0 * 2.0 * wpi::math::pi / 60.0;
+constexpr double kMaxVoltage = 12.0;
+
+bool ReadLog(const char* path,
+             std::vector<FlywheelCharacterizationSample>& samples) {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{
+        std::fopen(path, "rb"), &std::fclose};
+    if (file == nullptr) {
+        fmt::print(stderr, "error: failed to open {}\n", path);
+        return false;
+    }
+
+    FlywheelCharacterizationHeader header;
+    if (std::fread(&header, sizeof(header), 1, file.get()) != 1 ||
+        header.magic != FlywheelCharacterizationHeader::kMagic) {
+        fmt::print(stderr, "error: {} isn't a characterization log\n", path);
+        return false;
+    }
+    if (header.version != FlywheelCharacterizationHeader::kVersion ||
+        header.sampleSize != sizeof(FlywheelCharacterizationSample)) {
+        fmt::print(stderr, "error: {} has unsupported version {}\n", path,
+                   header.version);
+        return false;
+    }
+
+    // Read the samples in one call rather than parsing record by record
+    std::fseek(file.get(), 0, SEEK_END);
+    long end = std::ftell(file.get());
+    std::fseek(file.get(), sizeof(header), SEEK_SET);
+    samples.resize((end - static_cast<long>(sizeof(header))) /
+                   sizeof(FlywheelCharacterizationSample));
+    if (std::fread(samples.data(), sizeof(FlywheelCharacterizationSample),
+                   samples.size(), file.get()) != samples.size()) {
+        fmt::print(stderr, "error: failed to read {}\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        fmt::print(stderr, "usage: {} <log> [output JSON]\n", argv[0]);
+        return 1;
+    }
+    const char* outputPath = argc == 3 ? argv[2] : "flywheel.json";
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<FlywheelCharacterizationSample> samples;
+    if (!ReadLog(argv[1], samples)) {
+        return 1;
+    }
+
+    FlywheelFitter fitter;
+    for (const auto& sample : samples) {
+        fitter.AddSample(sample.timestamp * 1e-6, sample.voltage,
+                         sample.angularVelocity * 2.0 * wpi::math::pi / 60.0);
+    }
+    FlywheelFit fit = fitter.Fit();
+
+    auto end = std::chrono::steady_clock::now();
+
+    if (fit.samples == 0) {
+        fmt::print(stderr,
+                   "error: {} samples don't determine the flywheel model\n",
+                   samples.size());
+        return 1;
+    }
+
+    double kP = ComputeLQRGain(fit, kControllerPeriod, kVelocityTolerance,
+                               kMaxVoltage);
+
+    fmt::print("Fit {} of {} samples in {:.1f} ms\n", fit.samples,
+               samples.size(),
+               std::chrono::duration<double, std::milli>(end - start).count());
+    fmt::print("  kS = {:.4g} V\n", fit.kS);
+    fmt::print("  kV = {:.4g} V/(rad/s) ({:.0f} RPM free speed at 12 V)\n",
+               fit.kV, 12.0 / fit.kV * 60.0 / (2.0 * wpi::math::pi));
+    fmt::print("  kA = {:.4g} V/(rad/s²)\n", fit.kA);
+    fmt::print("  r² = {:.4f}\n", fit.rSquared);
+    fmt::print("Recommended LQR gain at {} ms: {:.4g} V/(rad/s)\n",
+               kControllerPeriod * 1e3, kP);
+
+    // fmt's default flags don't truncate an existing file
+    auto output = fmt::output_file(
+        outputPath, fmt::file::WRONLY | fmt::file::CREATE | O_TRUNC);
+    output.print("{{\n");
+    output.print("  \"kS\": {},\n", fit.kS);
+    output.print("  \"kV\": {},\n", fit.kV);
+    output.print("  \"kA\": {},\n", fit.kA);
+    output.print("  \"kP\": {},\n", kP);
+    output.print("  \"dt\": {},\n", fit.dt);
+    output.print("  \"rSquared\": {},\n", fit.rSquared);
+    output.print("  \"samples\": {}\n", fit.samples);
+    output.print("}}\n");
+    output.close();
+
+    fmt::print("Wrote {}\n", outputPath);
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+/**
+ * Result of a flywheel characterization fit. Velocities are in rad/s.
+ */
+struct FlywheelFit {
+    // Voltage needed to overcome static friction in volts
+    double kS = 0.0;
+
+    // Volts per rad/s
+    double kV = 0.0;
+
+    // Volts per rad/s²
+    double kA = 0.0;
+
+    // Mean sample period in seconds
+    double dt = 0.0;
+
+    // Coefficient of determination of the discrete-time fit
+    double rSquared = 0.0;
+
+    // Number of sample pairs used
+    size_t samples = 0;
+};
+
+/**
+ * Fits the flywheel model V = kS sgn(ω) + kV ω + kA dω/dt to a characterization
+ * log.
+ *
+ * The discrete-time form ω[k+1] = a ω[k] + b V[k] + c sgn(ω[k]) is fit with
+ * ordinary least squares, then converted to the continuous-time constants.
+ * Samples are streamed into the normal equations, so memory use doesn't grow
+ * with the length of the log.
+ */
+class FlywheelFitter {
+public:
+    // Sample pairs further apart than this are skipped, so gaps in the log
+    // don't corrupt the fit
+    static constexpr double kMaxPeriod = 0.05;
+
+    /**
+     * Adds a sample. Samples must be added in timestamp order.
+     *
+     * @param timestamp       Sample time in seconds.
+     * @param voltage         Applied voltage in volts.
+     * @param angularVelocity Measured angular velocity in rad/s.
+     */
+    void AddSample(double timestamp, double voltage, double angularVelocity);
+
+    /**
+     * Solves for the model constants.
+     *
+     * Returns a fit with zero samples if the data doesn't determine the model,
+     * such as a log without any voltage applied.
+     */
+    FlywheelFit Fit() const;
+
+private:
+    Eigen::Matrix3d m_xtx = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d m_xty = Eigen::Vector3d::Zero();
+    double m_yty = 0.0;
+    double m_ySum = 0.0;
+    double m_dtSum = 0.0;
+    size_t m_count = 0;
+
+    bool m_hasPrevious = false;
+    double m_prevTimestamp = 0.0;
+    double m_prevVoltage = 0.0;
+    double m_prevVelocity = 0.0;
+};
+
+/**
+ * Returns the steady-state LQR gain for the discretized flywheel model in
+ * volts per rad/s.
+ *
+ * The scalar discrete algebraic Riccati equation is solved in closed form.
+ *
+ * @param fit                Identified model.
+ * @param dt                 Controller period in seconds.
+ * @param velocityTolerance  Maximum desired velocity error in rad/s.
+ * @param maxVoltage         Maximum desired control voltage.
+ */
+double ComputeLQRGain(const FlywheelFit& fit, double dt,
+                      double velocityTolerance, double maxVoltage);
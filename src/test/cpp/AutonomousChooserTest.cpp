@@ -0,0 +1,125 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "AutonomousChooser.hpp"
+
+using ExecutionMode = frc3512::AutonomousChooser::ExecutionMode;
+
+class AutonomousChooserTest : public testing::TestWithParam<ExecutionMode> {};
+
+TEST_P(AutonomousChooserTest, YieldToMain) {
+    int slices = 0;
+    frc3512::AutonomousChooser chooser{"No-op", [] {}};
+    chooser.AddAutonomous("Count", [&] {
+        for (int i = 0; i < 3; ++i) {
+            ++slices;
+            chooser.YieldToMain();
+        }
+        ++slices;
+    });
+    chooser.SetExecutionMode(GetParam());
+    chooser.SelectAutonomous("Count");
+
+    // Each call runs exactly one slice of the autonomous mode
+    chooser.AwaitStartAutonomous();
+    EXPECT_EQ(1, slices);
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(2, slices);
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(3, slices);
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(4, slices);
+
+    // Autonomous mode has returned, so this should be a no-op
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(4, slices);
+
+    chooser.EndAutonomous();
+}
+
+TEST_P(AutonomousChooserTest, AwaitAll) {
+    int first = 0;
+    int second = 0;
+    bool joined = false;
+    frc3512::AutonomousChooser chooser{"No-op", [] {}};
+    chooser.AddAutonomous("Parallel", [&] {
+        joined = chooser.AwaitAll(
+            {[&] {
+                 for (int i = 0; i < 2; ++i) {
+                     ++first;
+                     chooser.AwaitNextCycle();
+                 }
+             },
+             [&] {
+                 for (int i = 0; i < 4; ++i) {
+                     ++second;
+                     chooser.AwaitNextCycle();
+                 }
+             }});
+    });
+    chooser.SetExecutionMode(GetParam());
+    chooser.SelectAutonomous("Parallel");
+
+    // Both functions should make progress in the same cycle
+    chooser.AwaitStartAutonomous();
+    EXPECT_EQ(1, first);
+    EXPECT_EQ(1, second);
+
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(2, first);
+    EXPECT_EQ(2, second);
+
+    // The join waits for the longer function
+    chooser.AwaitRunAutonomous();
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(2, first);
+    EXPECT_EQ(4, second);
+    EXPECT_FALSE(joined);
+
+    chooser.AwaitRunAutonomous();
+    EXPECT_TRUE(joined);
+
+    chooser.EndAutonomous();
+}
+
+TEST_P(AutonomousChooserTest, UnknownSelectionIgnored) {
+    std::string ran;
+    frc3512::AutonomousChooser chooser{"No-op", [&] { ran = "No-op"; }};
+    chooser.AddAutonomous("Mode", [&] { ran = "Mode"; });
+    chooser.SetExecutionMode(GetParam());
+
+    chooser.SelectAutonomous("Mode");
+    chooser.SelectAutonomous("Nonexistent");
+
+    chooser.AwaitStartAutonomous();
+    chooser.EndAutonomous();
+    EXPECT_EQ("Mode", ran);
+}
+
+TEST_P(AutonomousChooserTest, EndAutonomousCancels) {
+    int cycles = 0;
+    frc3512::AutonomousChooser chooser{"No-op", [] {}};
+    chooser.AddAutonomous("Forever", [&] {
+        while (chooser.AwaitNextCycle()) {
+            ++cycles;
+        }
+    });
+    chooser.SetExecutionMode(GetParam());
+    chooser.SelectAutonomous("Forever");
+
+    chooser.AwaitStartAutonomous();
+    chooser.AwaitRunAutonomous();
+    chooser.AwaitRunAutonomous();
+    EXPECT_EQ(2, cycles);
+
+    // The mode function should observe the cancellation and return
+    chooser.EndAutonomous();
+    EXPECT_EQ(2, cycles);
+}
+
+INSTANTIATE_TEST_SUITE_P(AutonomousChooserTests, AutonomousChooserTest,
+                         testing::Values(ExecutionMode::kThread,
+                                         ExecutionMode::kCoroutine));
@@ -0,0 +1,91 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/compile.h>
+#include <gtest/gtest.h>
+
+#include "telemetry/ConsoleLog.hpp"
+#include "telemetry/MpscRing.hpp"
+
+namespace {
+
+std::string ToString(const frc3512::ConsoleLine& line) {
+    return std::string{line.text, line.size};
+}
+
+}  // namespace
+
+TEST(ConsoleLogTest, FormatsLine) {
+    auto line = frc3512::FormatConsoleLine(
+        frc3512::ConsoleStream::kError,
+        FMT_COMPILE("{}: {:.3f} s, {} cycles\n"), "DriveDistance", 1.5, 75);
+    EXPECT_EQ(frc3512::ConsoleStream::kError, line.stream);
+    EXPECT_EQ("DriveDistance: 1.500 s, 75 cycles\n", ToString(line));
+}
+
+TEST(ConsoleLogTest, TruncatesLongLine) {
+    std::string name(300, 'a');
+    auto line = frc3512::FormatConsoleLine(frc3512::ConsoleStream::kOut,
+                                           FMT_COMPILE("{} autonomous\n"),
+                                           name);
+    ASSERT_EQ(frc3512::ConsoleLine::kCapacity, line.size);
+    EXPECT_EQ(std::string(frc3512::ConsoleLine::kCapacity - 4, 'a') + "...\n",
+              ToString(line));
+}
+
+TEST(ConsoleLogTest, MpscRingDeliversFromEveryProducer) {
+    constexpr int kProducers = 4;
+    constexpr int kValuesPerProducer = 100000;
+
+    frc3512::MpscRing<int, 64> ring;
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kProducers; ++producer) {
+        producers.emplace_back([&, producer] {
+            for (int i = 0; i < kValuesPerProducer; ++i) {
+                while (!ring.Push(producer * kValuesPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each producer's values must arrive in the order it pushed them
+    std::array<int, kProducers> next{};
+    int received = 0;
+    while (received < kProducers * kValuesPerProducer) {
+        int value;
+        if (!ring.Pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        int producer = value / kValuesPerProducer;
+        ASSERT_EQ(next[producer], value % kValuesPerProducer);
+        ++next[producer];
+        ++received;
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    int value;
+    EXPECT_FALSE(ring.Pop(value));
+}
+
+TEST(ConsoleLogTest, MpscRingRejectsPushWhenFull) {
+    frc3512::MpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.Push(i));
+    }
+    EXPECT_FALSE(ring.Push(4));
+
+    int value;
+    ASSERT_TRUE(ring.Pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(ring.Push(4));
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <units/time.h>
+
+#include "EdgeVelocityEstimator.hpp"
+
+TEST(EdgeVelocityEstimatorTest, ConstantVelocity) {
+    constexpr double kEdgesPerSecond = 250.0;
+
+    for (bool fitAcceleration : {false, true}) {
+        EdgeVelocityEstimator estimator{8, fitAcceleration};
+
+        units::second_t t = 0_s;
+        for (int i = 0; i < 20; ++i) {
+            t = units::second_t{i / kEdgesPerSecond};
+            estimator.AddEdge(t);
+        }
+
+        EXPECT_NEAR(kEdgesPerSecond, estimator.GetVelocity(t), 1e-6);
+        EXPECT_NEAR(0.0, estimator.GetAcceleration(t), 1e-3);
+    }
+}
+
+TEST(EdgeVelocityEstimatorTest, ConstantAcceleration) {
+    constexpr double kInitialVelocity = 100.0;
+    constexpr double kAcceleration = 500.0;
+
+    EdgeVelocityEstimator estimator{8, true};
+
+    // Edge k is where the position v₀t + at²/2 reaches k
+    units::second_t t = 0_s;
+    for (int k = 0; k < 30; ++k) {
+        t = units::second_t{
+            (-kInitialVelocity + std::sqrt(kInitialVelocity * kInitialVelocity +
+                                           2.0 * kAcceleration * k)) /
+            kAcceleration};
+        estimator.AddEdge(t);
+    }
+
+    // The quadratic fit is exact, so the velocity at the newest edge has no
+    // lag
+    EXPECT_NEAR(kInitialVelocity + kAcceleration * t.to<double>(),
+                estimator.GetVelocity(t), 1e-4);
+    EXPECT_NEAR(kAcceleration, estimator.GetAcceleration(t), 1e-2);
+}
+
+TEST(EdgeVelocityEstimatorTest, NoisyEdges) {
+    constexpr double kEdgesPerSecond = 400.0;
+
+    std::mt19937 generator{3512};
+    std::normal_distribution<double> jitter{0.0, 20e-6};
+
+    EdgeVelocityEstimator estimator{16, false};
+
+    // Average of a five-period window like the Counter uses, for comparison
+    double worstEstimatorError = 0.0;
+    double worstAverageError = 0.0;
+    double times[5] = {};
+
+    units::second_t t = 0_s;
+    for (int i = 0; i < 200; ++i) {
+        t = units::second_t{i / kEdgesPerSecond + jitter(generator)};
+        estimator.AddEdge(t);
+
+        for (int j = 0; j < 4; ++j) {
+            times[j] = times[j + 1];
+        }
+        times[4] = t.to<double>();
+
+        if (i >= 16) {
+            worstEstimatorError =
+                std::max(worstEstimatorError,
+                         std::abs(estimator.GetVelocity(t) - kEdgesPerSecond));
+            worstAverageError = std::max(
+                worstAverageError,
+                std::abs(4.0 / (times[4] - times[0]) - kEdgesPerSecond));
+        }
+    }
+
+    EXPECT_LT(worstEstimatorError, worstAverageError);
+    EXPECT_LT(worstEstimatorError, 0.02 * kEdgesPerSecond);
+}
+
+TEST(EdgeVelocityEstimatorTest, LinearFitIsLessNoisy) {
+    // The shooter's edge rate at 5000 RPM with 56 teeth and a 4:1 ratio
+    constexpr double kEdgesPerSecond = 5000.0 * 56.0 / (4.0 * 60.0);
+
+    // Root mean square error of each fit with timestamps quantized to the
+    // FPGA's microsecond resolution
+    double rmsErrors[2];
+    for (bool fitAcceleration : {false, true}) {
+        std::mt19937 generator{3512};
+        std::uniform_real_distribution<double> jitter{-0.5e-6, 0.5e-6};
+
+        EdgeVelocityEstimator estimator{8, fitAcceleration};
+
+        double sumSquaredError = 0.0;
+        for (int i = 0; i < 1000; ++i) {
+            units::second_t t{i / kEdgesPerSecond + jitter(generator)};
+            estimator.AddEdge(t);
+
+            if (i >= 8) {
+                double error = estimator.GetVelocity(t) - kEdgesPerSecond;
+                sumSquaredError += error * error;
+            }
+        }
+        rmsErrors[fitAcceleration] = std::sqrt(sumSquaredError / 992);
+    }
+
+    EXPECT_LT(2.0 * rmsErrors[false], rmsErrors[true]);
+}
+
+TEST(EdgeVelocityEstimatorTest, MissedEdge) {
+    constexpr double kEdgesPerSecond = 1000.0;
+
+    EdgeVelocityEstimator estimator{8};
+
+    // Edge 15's interrupt never arrives, but the counter still counted it
+    units::second_t t = 0_s;
+    for (int k = 0; k < 20; ++k) {
+        if (k == 15) {
+            continue;
+        }
+        t = units::second_t{k / kEdgesPerSecond};
+        estimator.AddEdge(t, k + 1);
+
+        if (k >= 8) {
+            EXPECT_NEAR(kEdgesPerSecond, estimator.GetVelocity(t), 1e-6);
+        }
+    }
+}
+
+TEST(EdgeVelocityEstimatorTest, StoppedWheel) {
+    EdgeVelocityEstimator estimator{8, true, 0.5_s};
+
+    units::second_t t = 0_s;
+    for (int i = 0; i < 10; ++i) {
+        t = units::second_t{i * 0.01};
+        estimator.AddEdge(t);
+    }
+    EXPECT_NEAR(100.0, estimator.GetVelocity(t), 1e-6);
+
+    // With no new edges, the estimate can't exceed one edge per elapsed time
+    EXPECT_LE(estimator.GetVelocity(t + 0.1_s), 10.0);
+
+    // Past the maximum period, the wheel is considered stopped
+    EXPECT_EQ(0.0, estimator.GetVelocity(t + 0.6_s));
+}
+
+TEST(EdgeVelocityEstimatorTest, TooFewEdges) {
+    EdgeVelocityEstimator estimator;
+    estimator.AddEdge(0_s);
+    estimator.AddEdge(0.01_s);
+    EXPECT_EQ(0.0, estimator.GetVelocity(0.01_s));
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "FlywheelFitter.hpp"
+
+namespace {
+
+constexpr double kS = 0.4;
+constexpr double kV = 0.0229;
+constexpr double kA = 0.004;
+constexpr double kDt = 0.005;
+
+/**
+ * Runs a ramp and a step through the exact discretization of the flywheel
+ * model and feeds the result to the fitter.
+ *
+ * @param noise Standard deviation of the measurement noise in rad/s.
+ */
+FlywheelFit FitSimulatedLog(double noise) {
+    std::mt19937 generator{3512};
+    std::normal_distribution<double> measurementNoise{0.0, noise};
+
+    double A = -kV / kA;
+    double B = 1.0 / kA;
+    double a = std::exp(A * kDt);
+
+    FlywheelFitter fitter;
+    double velocity = 0.0;
+    for (int k = 0; k < 4000; ++k) {
+        double t = k * kDt;
+
+        double voltage;
+        if (t < 10.0) {
+            voltage = 0.75 * t;
+        } else if (t < 14.0) {
+            voltage = 0.0;
+        } else {
+            voltage = 8.0;
+        }
+
+        double measured = velocity;
+        if (noise > 0.0) {
+            measured += measurementNoise(generator);
+        }
+        fitter.AddSample(t, voltage, measured);
+
+        // Static friction only opposes motion once the wheel is spinning
+        double friction = velocity > 0.0 ? kS : 0.0;
+        velocity = a * velocity + (a - 1.0) / A * B * (voltage - friction);
+        if (velocity < 0.0) {
+            velocity = 0.0;
+        }
+    }
+
+    return fitter.Fit();
+}
+
+}  // namespace
+
+TEST(FlywheelFitterTest, ExactModel) {
+    FlywheelFit fit = FitSimulatedLog(0.0);
+
+    ASSERT_GT(fit.samples, 0u);
+    EXPECT_NEAR(kS, fit.kS, 0.02);
+    EXPECT_NEAR(kV, fit.kV, 1e-4);
+    EXPECT_NEAR(kA, fit.kA, 1e-4);
+    EXPECT_NEAR(kDt, fit.dt, 1e-9);
+    EXPECT_GT(fit.rSquared, 0.999);
+}
+
+TEST(FlywheelFitterTest, NoisyMeasurements) {
+    FlywheelFit fit = FitSimulatedLog(2.0);
+
+    ASSERT_GT(fit.samples, 0u);
+    EXPECT_NEAR(kV, fit.kV, 0.05 * kV);
+    EXPECT_NEAR(kA, fit.kA, 0.25 * kA);
+}
+
+TEST(FlywheelFitterTest, StationaryLog) {
+    FlywheelFitter fitter;
+    for (int k = 0; k < 100; ++k) {
+        fitter.AddSample(k * kDt, 0.0, 0.0);
+    }
+    EXPECT_EQ(0u, fitter.Fit().samples);
+}
+
+TEST(FlywheelFitterTest, LQRGainSolvesRiccati) {
+    FlywheelFit fit;
+    fit.kV = kV;
+    fit.kA = kA;
+
+    double gain = ComputeLQRGain(fit, kDt, 10.0, 12.0);
+
+    // Iterate the Riccati recursion to convergence for comparison
+    double a = std::exp(-kV / kA * kDt);
+    double b = (a - 1.0) / (-kV / kA) / kA;
+    double q = 1.0 / 100.0;
+    double r = 1.0 / 144.0;
+    double p = q;
+    for (int i = 0; i < 10000; ++i) {
+        p = q + a * a * p - a * a * b * b * p * p / (r + b * b * p);
+    }
+
+    EXPECT_NEAR(a * b * p / (r + b * b * p), gain, 1e-9);
+}
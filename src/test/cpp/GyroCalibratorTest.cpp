@@ -0,0 +1,112 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <frc/simulation/AnalogInputSim.h>
+#include <frc/simulation/SimHooks.h>
+#include <gtest/gtest.h>
+#include <wpi/json.h>
+
+#include "GyroCalibrator.hpp"
+
+namespace {
+
+constexpr int kChannel = 3;
+constexpr const char* kPath = "gyro-calibration-test.json";
+
+void WriteFile(const std::string& contents) {
+    std::ofstream file{kPath};
+    file << contents;
+}
+
+std::string ReadFile() {
+    std::ifstream file{kPath};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+}  // namespace
+
+TEST(GyroCalibratorTest, ReusesSavedCalibration) {
+    WriteFile(R"({"center": 2048, "offset": 0.25})");
+
+    {
+        // The simulated gyro doesn't drift, so the saved calibration is kept
+        GyroCalibrator calibrator{kChannel, kPath};
+        EXPECT_EQ(2048, calibrator.GetGyro().GetCenter());
+        EXPECT_DOUBLE_EQ(0.25, calibrator.GetGyro().GetOffset());
+    }
+
+    std::remove(kPath);
+}
+
+TEST(GyroCalibratorTest, RecalibratesWithoutValidFile) {
+    WriteFile("not a calibration");
+
+    {
+        GyroCalibrator calibrator{kChannel, kPath};
+
+        // The full calibration's result replaces the invalid file
+        auto json = wpi::json::parse(ReadFile());
+        EXPECT_EQ(calibrator.GetGyro().GetCenter(),
+                  json.at("center").get<int>());
+        EXPECT_DOUBLE_EQ(calibrator.GetGyro().GetOffset(),
+                         json.at("offset").get<double>());
+    }
+
+    std::remove(kPath);
+}
+
+TEST(GyroCalibratorTest, SavesBackgroundCalibrationIfChanged) {
+    WriteFile(R"({"center": 2048, "offset": 0.25})");
+    frc::sim::PauseTiming();
+
+    {
+        GyroCalibrator calibrator{kChannel, kPath};
+        frc::sim::AnalogInputSim input{kChannel};
+
+        // Runs a background calibration that accumulates the given value
+        // over 1000 samples while stationary
+        auto calibrate = [&](int64_t value) {
+            std::string contents = ReadFile();
+            calibrator.StartBackgroundCalibration();
+            input.SetAccumulatorValue(0);
+            input.SetAccumulatorCount(0);
+            calibrator.UpdateBackgroundCalibration(true);
+
+            // Moving restarts the measurement
+            frc::sim::StepTiming(GyroCalibrator::kCalibrationTime / 2);
+            calibrator.UpdateBackgroundCalibration(false);
+            calibrator.UpdateBackgroundCalibration(true);
+            frc::sim::StepTiming(GyroCalibrator::kCalibrationTime / 2);
+            input.SetAccumulatorValue(value);
+            input.SetAccumulatorCount(1000);
+            calibrator.UpdateBackgroundCalibration(true);
+            EXPECT_EQ(contents, ReadFile());
+
+            frc::sim::StepTiming(GyroCalibrator::kCalibrationTime / 2);
+            calibrator.UpdateBackgroundCalibration(true);
+        };
+
+        // The average sample is 2048 + 1300 / 1000
+        calibrate(1300);
+        auto json = wpi::json::parse(ReadFile());
+        EXPECT_EQ(2049, json.at("center").get<int>());
+        EXPECT_NEAR(0.3, json.at("offset").get<double>(), 1e-9);
+
+        // The gyro keeps its calibration until the next boot
+        EXPECT_EQ(2048, calibrator.GetGyro().GetCenter());
+
+        // An unchanged calibration isn't saved again
+        std::remove(kPath);
+        calibrate(1300);
+        EXPECT_TRUE(ReadFile().empty());
+    }
+
+    frc::sim::ResumeTiming();
+    std::remove(kPath);
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <frc/geometry/Pose2d.h>
+#include <gtest/gtest.h>
+#include <units/angle.h>
+#include <units/length.h>
+
+#include "controllers/HolonomicTrajectoryController.hpp"
+
+using WheelVector = HolonomicTrajectoryController::WheelVector;
+
+namespace {
+
+void ExpectWheelSpeeds(const WheelVector& expected, const WheelVector& actual) {
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NEAR(expected(i), actual(i), 1e-6) << "wheel " << i;
+    }
+}
+
+}  // namespace
+
+TEST(HolonomicTrajectoryControllerTest, FeedsForwardOnReference) {
+    HolonomicTrajectoryController controller;
+
+    // Strafing right drives the front-left and rear-right wheels forward
+    frc3512::TrajectorySample reference{};
+    reference.vy = -1.0f;
+    auto speeds = controller.Calculate(frc::Pose2d{}, reference);
+
+    WheelVector expected;
+    expected << 1.0, -1.0, -1.0, 1.0;
+    ExpectWheelSpeeds(expected, speeds);
+    EXPECT_TRUE(controller.AtReference());
+}
+
+TEST(HolonomicTrajectoryControllerTest, CorrectsPositionInRobotFrame) {
+    HolonomicTrajectoryController controller;
+
+    // The reference is ahead on the field, which is to the right of a robot
+    // facing left
+    frc3512::TrajectorySample reference{};
+    reference.x = 0.1f;
+    reference.heading =
+        static_cast<float>(units::radian_t{90_deg}.to<double>());
+    auto speeds =
+        controller.Calculate(frc::Pose2d{0_m, 0_m, 90_deg}, reference);
+
+    double correction =
+        0.1 * HolonomicTrajectoryController::kTranslationGain.to<double>();
+    WheelVector expected;
+    expected << 1.0, -1.0, -1.0, 1.0;
+    ExpectWheelSpeeds(expected * correction, speeds);
+    EXPECT_FALSE(controller.AtReference());
+}
+
+TEST(HolonomicTrajectoryControllerTest, TurnsShortWayAcrossWrap) {
+    HolonomicTrajectoryController controller;
+
+    // -179 degrees is 2 degrees counterclockwise of 179 degrees
+    frc3512::TrajectorySample reference{};
+    reference.heading =
+        static_cast<float>(units::radian_t{-179_deg}.to<double>());
+    auto speeds =
+        controller.Calculate(frc::Pose2d{0_m, 0_m, 179_deg}, reference);
+
+    // Turning counterclockwise drives the left wheels backward and the right
+    // wheels forward
+    EXPECT_LT(speeds(0), 0.0);
+    EXPECT_LT(speeds(1), 0.0);
+    EXPECT_GT(speeds(2), 0.0);
+    EXPECT_GT(speeds(3), 0.0);
+    EXPECT_LT(speeds.cwiseAbs().maxCoeff(), 0.1);
+}
+
+TEST(HolonomicTrajectoryControllerTest, DesaturationKeepsDirection) {
+    HolonomicTrajectoryController controller;
+
+    frc3512::TrajectorySample reference{};
+    reference.x = 10.0f;
+    reference.y = 5.0f;
+    auto speeds = controller.Calculate(frc::Pose2d{}, reference);
+
+    EXPECT_NEAR(MecanumVelocityController::kMaxSpeed.to<double>(),
+                speeds.cwiseAbs().maxCoeff(), 1e-9);
+
+    // Forward and left at 2:1 puts the front-left and rear-right wheels at a
+    // third of the others
+    EXPECT_NEAR(speeds(1) / 3.0, speeds(0), 1e-9);
+    EXPECT_NEAR(speeds(2) / 3.0, speeds(3), 1e-9);
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "LatencyHistogram.hpp"
+
+using frc3512::LatencyHistogram;
+
+TEST(LatencyHistogramTest, BucketsAreContiguous) {
+    for (size_t i = 0; i < LatencyHistogram::kNumBuckets; ++i) {
+        uint64_t lower = LatencyHistogram::BucketLowerBound(i);
+        EXPECT_EQ(i, LatencyHistogram::BucketIndex(lower));
+        if (i > 0) {
+            EXPECT_EQ(i - 1, LatencyHistogram::BucketIndex(lower - 1));
+        }
+    }
+
+    // Durations past the range go in the last bucket
+    EXPECT_EQ(LatencyHistogram::kNumBuckets - 1,
+              LatencyHistogram::BucketIndex(UINT64_MAX));
+}
+
+TEST(LatencyHistogramTest, WindowStatistics) {
+    LatencyHistogram histogram;
+
+    // 1 us to 100 us in 1 us steps
+    for (uint64_t i = 1; i <= 100; ++i) {
+        histogram.Record(i * 1000);
+    }
+
+    auto window = histogram.TakeWindow();
+    EXPECT_EQ(100u, window.count);
+    EXPECT_EQ(1000u, window.min);
+    EXPECT_EQ(100000u, window.max);
+    EXPECT_DOUBLE_EQ(50500.0, window.Mean());
+
+    // Percentiles are within the 12.5% bucket width above the exact value
+    uint64_t p50 = window.Percentile(50.0);
+    EXPECT_GE(p50, 50000u);
+    EXPECT_LE(p50, 50000u * 9 / 8);
+    uint64_t p99 = window.Percentile(99.0);
+    EXPECT_GE(p99, 99000u);
+    EXPECT_LE(p99, 100000u);
+
+    // The next window only contains what was recorded after the last one
+    histogram.Record(5000);
+    window = histogram.TakeWindow();
+    EXPECT_EQ(1u, window.count);
+    EXPECT_EQ(5000u, window.min);
+    EXPECT_EQ(5000u, window.max);
+    EXPECT_EQ(5000u, window.Percentile(99.0));
+
+    window = histogram.TakeWindow();
+    EXPECT_EQ(0u, window.count);
+    EXPECT_EQ(0u, window.Percentile(99.0));
+}
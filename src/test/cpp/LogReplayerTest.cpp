@@ -0,0 +1,118 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cmath>
+#include <cstdint>
+
+#include <frc/simulation/DriverStationSim.h>
+#include <frc2/Timer.h>
+#include <gtest/gtest.h>
+#include <units/time.h>
+
+#include "LogReplayer.hpp"
+#include "MatchSimulator.hpp"
+
+using frc3512::MatchSimulator;
+using Mode = frc3512::MatchSimulator::Mode;
+
+namespace {
+
+uint64_t GetTimestamp() {
+    return static_cast<uint64_t>(
+        std::llround(units::microsecond_t{frc2::Timer::GetFPGATimestamp()}
+                         .to<double>()));
+}
+
+/**
+ * Sets the joysticks like a driver would during the given robot loop.
+ */
+void SetJoysticks(int loop) {
+    for (int stick : {1, 2}) {
+        frc::sim::DriverStationSim::SetJoystickAxisCount(stick, 3);
+        frc::sim::DriverStationSim::SetJoystickButtonCount(stick, 12);
+    }
+
+    // Strafe in a circle while turning slowly
+    double angle = loop * 0.02;
+    frc::sim::DriverStationSim::SetJoystickAxis(1, 0, 0.6 * std::cos(angle));
+    frc::sim::DriverStationSim::SetJoystickAxis(1, 1, 0.6 * std::sin(angle));
+    frc::sim::DriverStationSim::SetJoystickAxis(1, 2, 0.2);
+
+    // Toggle field-oriented driving off and back on with buttons 6 and 5, and
+    // raise the climbing arms with button 6 of the other stick
+    uint32_t driveButtons = 0;
+    if (loop == 50) {
+        driveButtons = 1 << 5;
+    } else if (loop == 100) {
+        driveButtons = 1 << 4;
+    }
+    frc::sim::DriverStationSim::SetJoystickButtons(1, driveButtons);
+    frc::sim::DriverStationSim::SetJoystickButtons(2,
+                                                   loop == 75 ? 1 << 5 : 0);
+
+    frc::sim::DriverStationSim::NotifyNewData();
+}
+
+/**
+ * Drives the simulated robot in teleop and logs its inputs and outputs the
+ * way the robot does.
+ */
+frc3512::ReplayLog RecordTeleop() {
+    frc3512::ReplayLog log;
+
+    MatchSimulator simulator;
+    auto& robot = simulator.GetRobot();
+    simulator.Run(Mode::kDisabled, 0.5_s);
+
+    // The sensors only change at the end of each loop, so the inputs the next
+    // loop reads are known after the previous one
+    int loop = 0;
+    auto logInputs = [&] {
+        SetJoysticks(loop++);
+        log.inputs.push_back({GetTimestamp() + 20000, robot.GetInputs()});
+    };
+
+    // Run() enables teleop at the start, but the first inputs are logged
+    // before that
+    frc::sim::DriverStationSim::SetEnabled(true);
+    logInputs();
+    simulator.Run(Mode::kTeleop, 3_s, [&] {
+        log.outputs.push_back({GetTimestamp(), robot.GetOutputs()});
+        logInputs();
+    });
+
+    // The last inputs are for a loop that didn't run
+    log.inputs.pop_back();
+
+    return log;
+}
+
+}  // namespace
+
+TEST(LogReplayerTest, ReplayMatchesRecording) {
+    auto log = RecordTeleop();
+    ASSERT_EQ(150u, log.inputs.size());
+
+    auto result = frc3512::LogReplayer{log}.Run();
+    EXPECT_EQ(150u, result.loops);
+    EXPECT_EQ(150u, result.compared);
+    for (const auto& diff : result.diffs) {
+        ADD_FAILURE() << diff.name << " differed in " << diff.mismatches
+                      << " loops, first at " << diff.firstTimestamp << " us";
+    }
+}
+
+TEST(LogReplayerTest, ReportsFirstDivergence) {
+    auto log = RecordTeleop();
+
+    // A gyro that drifted changes the field-oriented drive outputs
+    for (size_t i = 120; i < log.inputs.size(); ++i) {
+        log.inputs[i].record.gyroAngle += 45.0f;
+    }
+
+    auto result = frc3512::LogReplayer{log}.Run();
+    ASSERT_FALSE(result.Matches());
+    for (const auto& diff : result.diffs) {
+        EXPECT_EQ(log.inputs[120].timestamp, diff.firstTimestamp)
+            << diff.name;
+    }
+}
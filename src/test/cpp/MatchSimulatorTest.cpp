@@ -0,0 +1,114 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <gtest/gtest.h>
+#include <units/angular_velocity.h>
+
+#include "MatchSimulator.hpp"
+
+using frc3512::MatchSimulator;
+using Mode = frc3512::MatchSimulator::Mode;
+
+namespace {
+
+std::vector<std::string> GetAutonomousNames() {
+    MatchSimulator simulator;
+    return simulator.GetRobot().GetAutonomousChooser().GetAutonomousNames();
+}
+
+/**
+ * Runs a short disabled period, a full autonomous period, and a short teleop
+ * period with the given autonomous mode selected.
+ */
+std::vector<frc3512::MatchSnapshot> RunMatch(const std::string& autonMode) {
+    MatchSimulator simulator;
+    simulator.GetRobot().GetAutonomousChooser().SelectAutonomous(autonMode);
+
+    simulator.Run(Mode::kDisabled, 1_s);
+    simulator.Run(Mode::kAutonomous, MatchSimulator::kAutonomousDuration);
+    simulator.Run(Mode::kTeleop, 1_s);
+    simulator.Run(Mode::kDisabled, 0.1_s);
+
+    return simulator.GetSnapshots();
+}
+
+}  // namespace
+
+TEST(MatchSimulatorTest, AutonomousModesAreReproducible) {
+    auto names = GetAutonomousNames();
+    ASSERT_FALSE(names.empty());
+
+    for (const auto& name : names) {
+        auto start = std::chrono::steady_clock::now();
+        auto first = RunMatch(name);
+        auto end = std::chrono::steady_clock::now();
+        auto second = RunMatch(name);
+
+        fmt::print("{}: {} loop iterations in {:.1f} ms\n", name, first.size(),
+                   std::chrono::duration<double, std::milli>(end - start)
+                       .count());
+
+        ASSERT_EQ(first.size(), second.size()) << name;
+        for (size_t i = 0; i < first.size(); ++i) {
+            ASSERT_EQ(first[i], second[i])
+                << name << " diverged at " << first[i].timestamp.to<double>()
+                << " s";
+        }
+    }
+}
+
+TEST(MatchSimulatorTest, AutonomousModesMoveActuators) {
+    for (const auto& name : GetAutonomousNames()) {
+        if (name == "No-op") {
+            continue;
+        }
+
+        auto snapshots = RunMatch(name);
+
+        // Every routine except the no-op spins up the shooter and feeds
+        // discs, so some motor output and the feed solenoid must change
+        bool movedMotor = false;
+        bool fedDisc = false;
+        for (const auto& snapshot : snapshots) {
+            for (double speed : snapshot.pwmSpeeds) {
+                movedMotor |= speed != 0.0;
+            }
+            for (bool solenoid : snapshot.solenoids) {
+                fedDisc |= solenoid;
+            }
+        }
+        EXPECT_TRUE(movedMotor) << name;
+        EXPECT_TRUE(fedDisc) << name;
+    }
+}
+
+TEST(MatchSimulatorTest, FeedWaitsForIntervalAfterShooterTimeout) {
+    MatchSimulator simulator;
+    auto& robot = simulator.GetRobot();
+    robot.GetAutonomousChooser().SelectAutonomous("TwoDisc");
+
+    // The flywheel never appears to spin, so WaitForShooter() times out
+    robot.GetShooter().SetSimulatedMeasurementSource([] { return 0_rpm; });
+
+    simulator.Run(Mode::kDisabled, 1_s);
+    auto autonStart = simulator.GetSnapshots().back().timestamp;
+    simulator.Run(Mode::kAutonomous, MatchSimulator::kAutonomousDuration);
+
+    // Solenoid 1 feeds frisbees
+    units::second_t firstFeed = 0_s;
+    for (const auto& snapshot : simulator.GetSnapshots()) {
+        if (snapshot.solenoids[1]) {
+            firstFeed = snapshot.timestamp;
+            break;
+        }
+    }
+
+    // The first frisbee waits out the feed interval after the 7 s timeout
+    // rather than being fed at whatever speed the flywheel has
+    ASSERT_NE(0_s, firstFeed);
+    EXPECT_GE(firstFeed - autonStart, 7_s + 1.4_s);
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <frc/simulation/DriverStationSim.h>
+#include <gtest/gtest.h>
+#include <units/angle.h>
+#include <units/length.h>
+
+#include "MatchSimulator.hpp"
+
+using frc3512::MatchSimulator;
+using Mode = frc3512::MatchSimulator::Mode;
+
+TEST(MecanumPoseEstimatorTest, TracksSimulatedPose) {
+    MatchSimulator simulator;
+    auto& robot = simulator.GetRobot();
+    simulator.Run(Mode::kDisabled, 0.5_s);
+
+    // Strafe diagonally while turning
+    frc::sim::DriverStationSim::SetJoystickAxisCount(1, 3);
+    frc::sim::DriverStationSim::SetJoystickAxis(1, 0, 0.5);
+    frc::sim::DriverStationSim::SetJoystickAxis(1, 1, -0.7);
+    frc::sim::DriverStationSim::SetJoystickAxis(1, 2, 0.3);
+    frc::sim::DriverStationSim::NotifyNewData();
+    simulator.Run(Mode::kTeleop, 2_s);
+
+    // The estimator sees each drivetrain update a loop later, so stop before
+    // comparing
+    for (int axis = 0; axis < 3; ++axis) {
+        frc::sim::DriverStationSim::SetJoystickAxis(1, axis, 0.0);
+    }
+    frc::sim::DriverStationSim::NotifyNewData();
+    simulator.Run(Mode::kTeleop, 1_s);
+
+    auto estimate = robot.GetEstimatedPose();
+    auto pose = robot.GetDriveSim().GetPose();
+    ASSERT_GT(units::inch_t{pose.Translation().Norm()}.to<double>(), 12.0);
+    EXPECT_NEAR(units::inch_t{pose.X()}.to<double>(),
+                units::inch_t{estimate.X()}.to<double>(), 0.5);
+    EXPECT_NEAR(units::inch_t{pose.Y()}.to<double>(),
+                units::inch_t{estimate.Y()}.to<double>(), 0.5);
+    auto headingError = (pose.Rotation() - estimate.Rotation()).Degrees();
+    EXPECT_NEAR(0.0, headingError.to<double>(), 0.5);
+}
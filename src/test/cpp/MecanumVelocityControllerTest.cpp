@@ -0,0 +1,73 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <gtest/gtest.h>
+#include <units/time.h>
+
+#include "controllers/MecanumVelocityController.hpp"
+
+using WheelVector = MecanumVelocityController::WheelVector;
+
+TEST(MecanumVelocityControllerTest, MixesLikeMecanumDrive) {
+    double maxSpeed = MecanumVelocityController::kMaxSpeed.to<double>();
+
+    // Forward drives every wheel forward at full speed
+    auto forward =
+        MecanumVelocityController::CartesianToWheelSpeeds(0.0, 1.0, 0.0);
+    EXPECT_TRUE(forward.isApprox(WheelVector::Constant(maxSpeed)));
+
+    // Strafing right drives the front-left and rear-right wheels forward
+    auto right =
+        MecanumVelocityController::CartesianToWheelSpeeds(0.5, 0.0, 0.0);
+    WheelVector expected;
+    expected << 1.0, -1.0, -1.0, 1.0;
+    double deadband = MecanumVelocityController::kDeadband;
+    EXPECT_TRUE(right.isApprox(expected * maxSpeed * (0.5 - deadband) /
+                               (1.0 - deadband)));
+
+    // Field-oriented commands are rotated by the negated gyro angle like
+    // MecanumDrive rotates them
+    auto fieldForward =
+        MecanumVelocityController::CartesianToWheelSpeeds(0.0, 1.0, 0.0, 90.0);
+    EXPECT_TRUE(fieldForward.isApprox(expected * maxSpeed));
+
+    // Commands over full speed are scaled down together
+    auto turning =
+        MecanumVelocityController::CartesianToWheelSpeeds(0.0, 1.0, 1.0);
+    expected << 1.0, 1.0, 0.0, 0.0;
+    EXPECT_TRUE(turning.isApprox(expected * maxSpeed));
+}
+
+TEST(MecanumVelocityControllerTest, FeedbackCorrectsSlowWheel) {
+    MecanumVelocityController controller{20_ms};
+
+    WheelVector references = WheelVector::Constant(1.0);
+    controller.Update(references, references);
+
+    // Once the reference is steady, only the slow wheel gets more voltage
+    WheelVector velocities = references;
+    velocities(1) = 0.8;
+    auto voltages = controller.Update(references, velocities);
+
+    double steady = MecanumVelocityController::kV.to<double>();
+    double correction = 0.2 * MecanumVelocityController::kP.to<double>();
+    EXPECT_NEAR(steady, voltages(0), 1e-9);
+    EXPECT_NEAR(steady + correction, voltages(1), 1e-9);
+    EXPECT_NEAR(steady, voltages(2), 1e-9);
+    EXPECT_NEAR(steady, voltages(3), 1e-9);
+}
+
+TEST(MecanumVelocityControllerTest, DesaturationKeepsWheelRatios) {
+    MecanumVelocityController controller{20_ms};
+
+    // Starting from rest, the acceleration feedforward saturates every wheel
+    WheelVector references;
+    references << 2.0, -1.0, 1.0, 0.5;
+    auto voltages = controller.Update(references, WheelVector::Zero());
+
+    EXPECT_NEAR(MecanumVelocityController::kMaxVoltage.to<double>(),
+                voltages.cwiseAbs().maxCoeff(), 1e-9);
+    for (int i = 1; i < 4; ++i) {
+        EXPECT_NEAR(references(i) / references(0), voltages(i) / voltages(0),
+                    1e-9);
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <random>
+
+#include <frc/simulation/FlywheelSim.h>
+#include <frc/system/plant/DCMotor.h>
+#include <frc/system/plant/LinearSystemId.h>
+#include <gtest/gtest.h>
+#include <units/angle.h>
+#include <units/angular_velocity.h>
+#include <units/math.h>
+#include <units/time.h>
+
+#include "controllers/FlywheelConstants.hpp"
+#include "controllers/StateSpaceFlywheelController.hpp"
+
+namespace {
+
+constexpr units::second_t kDt = 5_ms;
+constexpr auto kReference = 4000_rpm;
+
+}  // namespace
+
+TEST(StateSpaceFlywheelControllerTest, SpinsUpWithoutSteadyStateError) {
+    FlywheelConstants constants;
+    StateSpaceFlywheelController controller{constants, kDt};
+
+    // Same plant as the shooter's simulation
+    frc::sim::FlywheelSim flywheel{
+        frc::LinearSystemId::IdentifyVelocitySystem<units::radian>(
+            constants.kV, constants.kA),
+        frc::DCMotor::CIM(2), 1.0};
+
+    // Seeded so the encoder noise is the same every run
+    std::mt19937 generator{3512};
+    std::normal_distribution<double> noise{
+        0.0, StateSpaceFlywheelController::kMeasurementStdDev.to<double>()};
+
+    controller.Reset(0_rpm);
+    controller.SetReference(kReference);
+
+    units::second_t reachedTime = -1_s;
+    units::revolutions_per_minute_t worstSteadyStateError = 0_rpm;
+    for (int i = 0; i < 600; ++i) {
+        units::second_t t = i * kDt;
+
+        units::revolutions_per_minute_t measured =
+            flywheel.GetAngularVelocity() +
+            units::radians_per_second_t{noise(generator)};
+        units::volt_t voltage = controller.Update(measured);
+        EXPECT_LE(units::math::abs(voltage),
+                  StateSpaceFlywheelController::kMaxVoltage);
+
+        if (reachedTime < 0_s && controller.AtReference()) {
+            reachedTime = t;
+        }
+
+        // Once the flywheel has settled, the true velocity should track the
+        // reference closely despite the noisy measurements
+        if (t >= 2_s) {
+            worstSteadyStateError = units::math::max(
+                worstSteadyStateError,
+                units::math::abs(kReference - flywheel.GetAngularVelocity()));
+        }
+
+        flywheel.SetInputVoltage(voltage);
+        flywheel.Update(kDt);
+    }
+
+    EXPECT_GE(reachedTime, 0_s);
+    EXPECT_LT(reachedTime, 0.5_s);
+    EXPECT_TRUE(controller.AtReference());
+    EXPECT_LT(worstSteadyStateError, 0.01 * kReference);
+}
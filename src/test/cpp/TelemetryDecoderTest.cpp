@@ -0,0 +1,215 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "TelemetryDecoder.hpp"
+#include "telemetry/TelemetryRecords.hpp"
+
+namespace {
+
+class LogBuilder {
+public:
+    explicit LogBuilder(
+        uint32_t version = frc3512::TelemetryLogHeader::kVersion) {
+        frc3512::TelemetryLogHeader header;
+        header.version = version;
+        header.recordHeaderSize = sizeof(frc3512::TelemetryRecordHeader);
+        Append(&header, sizeof(header));
+    }
+
+    template <typename Record>
+    void Add(uint64_t timestamp, const Record& record) {
+        frc3512::TelemetryRecordHeader header;
+        header.timestamp = timestamp;
+        header.type = Record::kType;
+        header.size = sizeof(Record);
+        Append(&header, sizeof(header));
+        Append(&record, sizeof(record));
+    }
+
+    void AddRaw(uint64_t timestamp, frc3512::TelemetryRecordType type,
+                const std::vector<uint8_t>& payload) {
+        frc3512::TelemetryRecordHeader header;
+        header.timestamp = timestamp;
+        header.type = type;
+        header.size = static_cast<uint16_t>(payload.size());
+        Append(&header, sizeof(header));
+        Append(payload.data(), payload.size());
+    }
+
+    void Append(const void* data, size_t size) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        m_data.insert(m_data.end(), bytes, bytes + size);
+    }
+
+    const std::vector<uint8_t>& Get() const { return m_data; }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+frc3512::ShooterRecord MakeShooterRecord(float angularVelocity) {
+    frc3512::ShooterRecord record{};
+    record.reference = 3000.0f;
+    record.angularVelocity = angularVelocity;
+    record.voltage = 6.5f;
+    record.enabled = 1;
+    return record;
+}
+
+}  // namespace
+
+TEST(TelemetryDecoderTest, DecodesCsv) {
+    LogBuilder log;
+    log.Add(1000, MakeShooterRecord(2500.25f));
+    frc3512::FeederRecord feeder{};
+    feeder.numShot = 1;
+    feeder.totalToShoot = 2;
+    feeder.activated = 1;
+    log.Add(2000, feeder);
+    log.Add(3000, MakeShooterRecord(2999.5f));
+
+    TelemetryDecoder decoder{log.Get().data(), log.Get().size()};
+    EXPECT_EQ(3u, decoder.GetRecordCount());
+
+    auto files = decoder.Decode(TelemetryOutputFormat::kCsv, 2);
+    EXPECT_EQ(
+        "timestamp_us,reference_rpm,angular_velocity_rpm,voltage_v,enabled,"
+        "at_reference,characterizing,controller_type\n"
+        "1000,3000,2500.25,6.5,1,0,0,0\n"
+        "3000,3000,2999.5,6.5,1,0,0,0\n",
+        files.at("Shooter.csv"));
+    EXPECT_EQ(
+        "timestamp_us,num_shot,total_to_shoot,lifetime_shot,activated,"
+        "feed_extended,guard_lowered\n"
+        "2000,1,2,0,1,0,0\n",
+        files.at("Feeder.csv"));
+
+    // Record types that weren't logged still get a header
+    EXPECT_EQ(0u, files.at("Input.csv").find("timestamp_us,"));
+
+    auto shooter = decoder.GetRecords<frc3512::ShooterRecord>();
+    ASSERT_EQ(2u, shooter.size());
+    EXPECT_EQ(3000u, shooter[1].timestamp);
+    EXPECT_EQ(2999.5f, shooter[1].record.angularVelocity);
+}
+
+TEST(TelemetryDecoderTest, ThreadCountDoesNotChangeOutput) {
+    LogBuilder log;
+    for (int i = 0; i < 1000; ++i) {
+        log.Add(i * 5000, MakeShooterRecord(i * 1.5f));
+        if (i % 4 == 0) {
+            frc3512::InputRecord input{};
+            input.gyroAngle = i * 0.25f;
+            input.flCount = -i;
+            log.Add(i * 5000 + 1, input);
+        }
+    }
+
+    TelemetryDecoder decoder{log.Get().data(), log.Get().size()};
+    for (auto format :
+         {TelemetryOutputFormat::kCsv, TelemetryOutputFormat::kColumnar}) {
+        auto expected = decoder.Decode(format, 1);
+        EXPECT_EQ(expected, decoder.Decode(format, 7));
+    }
+
+    auto columns = decoder.Decode(TelemetryOutputFormat::kColumnar, 4);
+    const auto& velocities = columns.at("Shooter.angular_velocity_rpm.f32");
+    ASSERT_EQ(1000 * sizeof(float), velocities.size());
+    float velocity;
+    std::memcpy(&velocity, velocities.data() + 10 * sizeof(float),
+                sizeof(velocity));
+    EXPECT_EQ(15.0f, velocity);
+    EXPECT_EQ(250 * sizeof(uint64_t),
+              columns.at("Input.timestamp_us.u64").size());
+    EXPECT_EQ(250 * sizeof(int32_t), columns.at("Input.fl_count.i32").size());
+    EXPECT_EQ(1u, columns.count("schema.json"));
+}
+
+TEST(TelemetryDecoderTest, IgnoresPartialAndUnknownRecords) {
+    LogBuilder log;
+    log.Add(1000, MakeShooterRecord(1.0f));
+
+    // A record type from a newer build
+    frc3512::TelemetryRecordHeader unknown;
+    unknown.timestamp = 2000;
+    unknown.type = static_cast<frc3512::TelemetryRecordType>(99);
+    unknown.size = 8;
+    log.Append(&unknown, sizeof(unknown));
+    uint64_t payload = 0;
+    log.Append(&payload, sizeof(payload));
+
+    log.Add(3000, MakeShooterRecord(2.0f));
+
+    // Cut the last record short like a power loss would
+    auto data = log.Get();
+    data.resize(data.size() - 5);
+
+    TelemetryDecoder decoder{data.data(), data.size()};
+    EXPECT_EQ(1u, decoder.GetRecordCount());
+    EXPECT_EQ(1u, decoder.GetSkippedCount());
+    EXPECT_EQ(sizeof(frc3512::TelemetryRecordHeader) +
+                  sizeof(frc3512::ShooterRecord) - 5,
+              decoder.GetTruncatedSize());
+}
+
+TEST(TelemetryDecoderTest, DecodesVersion1Logs) {
+    LogBuilder log{1};
+
+    // The drive record that version 2 dropped
+    log.AddRaw(1000, static_cast<frc3512::TelemetryRecordType>(3),
+               std::vector<uint8_t>(24));
+
+    // Version 1 InputRecords didn't have the drive encoder rates
+    frc3512::InputRecord input{};
+    input.rrCount = 7;
+    input.gyroAngle = 12.5f;
+    input.batteryVoltage = 12.25f;
+    input.enabled = 1;
+    auto bytes = reinterpret_cast<const uint8_t*>(&input);
+    std::vector<uint8_t> payload(
+        bytes, bytes + offsetof(frc3512::InputRecord, flRate));
+    payload.insert(payload.end(),
+                   bytes + offsetof(frc3512::InputRecord, gyroAngle),
+                   bytes + sizeof(input));
+    log.AddRaw(2000, frc3512::TelemetryRecordType::kInput, payload);
+
+    TelemetryDecoder decoder{log.Get().data(), log.Get().size()};
+    EXPECT_EQ(1u, decoder.GetRecordCount());
+    EXPECT_EQ(1u, decoder.GetSkippedCount());
+
+    auto inputs = decoder.GetRecords<frc3512::InputRecord>();
+    ASSERT_EQ(1u, inputs.size());
+    EXPECT_EQ(2000u, inputs[0].timestamp);
+    EXPECT_EQ(7, inputs[0].record.rrCount);
+    EXPECT_TRUE(std::isnan(inputs[0].record.flRate));
+    EXPECT_TRUE(std::isnan(inputs[0].record.rrRate));
+    EXPECT_EQ(12.5f, inputs[0].record.gyroAngle);
+    EXPECT_EQ(12.25f, inputs[0].record.batteryVoltage);
+    EXPECT_EQ(1, inputs[0].record.enabled);
+
+    // Decode() reads the records the same way
+    auto files = decoder.Decode(TelemetryOutputFormat::kColumnar, 1);
+    float gyroAngle;
+    ASSERT_EQ(sizeof(gyroAngle),
+              files.at("Input.gyro_angle_deg.f32").size());
+    std::memcpy(&gyroAngle, files.at("Input.gyro_angle_deg.f32").data(),
+                sizeof(gyroAngle));
+    EXPECT_EQ(12.5f, gyroAngle);
+}
+
+TEST(TelemetryDecoderTest, RejectsOtherFiles) {
+    std::string text = "timestamp,voltage,angular velocity\n";
+    EXPECT_THROW(
+        (TelemetryDecoder{reinterpret_cast<const uint8_t*>(text.data()),
+                          text.size()}),
+        std::runtime_error);
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "telemetry/SpscRing.hpp"
+#include "telemetry/TelemetryLogger.hpp"
+#include "telemetry/TelemetryRecords.hpp"
+
+namespace {
+
+// Size of one logged FeederRecord including its header
+constexpr uint64_t kEntrySize =
+    sizeof(frc3512::TelemetryRecordHeader) + sizeof(frc3512::FeederRecord);
+
+uint64_t GetFileSize(const std::string& path) {
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    return static_cast<uint64_t>(file.tellg());
+}
+
+bool FileExists(const std::string& path) {
+    return std::ifstream{path}.good();
+}
+
+void WriteFile(const std::string& path, uint64_t size) {
+    std::ofstream file{path, std::ios::binary};
+    file << std::string(size, '\0');
+}
+
+/**
+ * Creates a uniquely named directory in the system's temporary directory and
+ * returns its path, or an empty string on failure.
+ */
+std::string MakeTemporaryDirectory() {
+#ifdef _WIN32
+    char base[MAX_PATH + 1];
+    if (GetTempPathA(sizeof(base), base) == 0) {
+        return "";
+    }
+    for (int i = 0;; ++i) {
+        std::string path = std::string{base} + "telemetry-logger-test-" +
+                           std::to_string(GetCurrentProcessId()) + "-" +
+                           std::to_string(i);
+        if (CreateDirectoryA(path.c_str(), nullptr)) {
+            return path;
+        }
+        if (GetLastError() != ERROR_ALREADY_EXISTS) {
+            return "";
+        }
+    }
+#else
+    const char* base = std::getenv("TMPDIR");
+    std::string path = std::string{base != nullptr ? base : "/tmp"} +
+                       "/telemetry-logger-test-XXXXXX";
+    return mkdtemp(path.data()) != nullptr ? path : "";
+#endif
+}
+
+/**
+ * Removes a directory and the files in it.
+ */
+void RemoveTemporaryDirectory(const std::string& directory) {
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "/*").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                std::remove((directory + "/" + data.cFileName).c_str());
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+    RemoveDirectoryA(directory.c_str());
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir != nullptr) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                std::remove((directory + "/" + name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(directory.c_str());
+#endif
+}
+
+/**
+ * Runs each test in its own temporary directory, so logs in the working
+ * directory are never touched.
+ */
+class TelemetryLoggerTest : public testing::Test {
+protected:
+    std::string m_directory;
+    std::string m_logPath;
+
+    void SetUp() override {
+        m_directory = MakeTemporaryDirectory();
+        ASSERT_FALSE(m_directory.empty());
+        m_logPath = m_directory + "/telemetry-logger-test.bin";
+    }
+
+    void TearDown() override {
+        if (!m_directory.empty()) {
+            RemoveTemporaryDirectory(m_directory);
+        }
+    }
+};
+
+}  // namespace
+
+TEST(SpscRingTest, FailsWhenFullAndKeepsOrder) {
+    frc3512::SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.Push(i));
+    }
+    EXPECT_FALSE(ring.Push(4));
+
+    // Popping makes room again, and the indices keep working past a wrap
+    int value;
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(ring.Pop(value));
+        EXPECT_EQ(i, value);
+        EXPECT_TRUE(ring.Push(i + 4));
+    }
+    for (int i = 6; i < 10; ++i) {
+        ASSERT_TRUE(ring.Pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(ring.Pop(value));
+}
+
+TEST_F(TelemetryLoggerTest, DiscardsRecordsWhilePaused) {
+    {
+        frc3512::TelemetryLogger logger;
+        auto& channel = logger.AddChannel<frc3512::FeederRecord>();
+        ASSERT_TRUE(logger.Start(m_logPath));
+
+        frc3512::FeederRecord record{};
+        channel.Log(record);
+
+        logger.SetPaused(true);
+        channel.Log(record);
+        channel.Log(record);
+
+        logger.SetPaused(false);
+        channel.Log(record);
+
+        logger.Stop();
+    }
+
+    EXPECT_EQ(sizeof(frc3512::TelemetryLogHeader) + 2 * kEntrySize,
+              GetFileSize(m_logPath));
+}
+
+TEST_F(TelemetryLoggerTest, StopsGrowingAtSizeLimit) {
+    {
+        frc3512::TelemetryLogger logger;
+        auto& channel = logger.AddChannel<frc3512::FeederRecord>();
+        ASSERT_TRUE(logger.Start(
+            m_logPath, sizeof(frc3512::TelemetryLogHeader) + 2 * kEntrySize));
+
+        frc3512::FeederRecord record{};
+        for (int i = 0; i < 5; ++i) {
+            channel.Log(record);
+        }
+
+        logger.Stop();
+    }
+
+    EXPECT_EQ(sizeof(frc3512::TelemetryLogHeader) + 2 * kEntrySize,
+              GetFileSize(m_logPath));
+}
+
+TEST_F(TelemetryLoggerTest, MakeLogPathDeletesOldestLogs) {
+    auto logPath = [&](int number) {
+        return m_directory + "/telemetry-" + std::to_string(number) + ".bin";
+    };
+    for (int i = 1; i <= 3; ++i) {
+        WriteFile(logPath(i), 1000);
+    }
+
+    // Two old logs and the new one fit
+    EXPECT_EQ(logPath(4), frc3512::TelemetryLogger::MakeLogPath(
+                              m_directory, 1000, 3000, 0));
+    EXPECT_FALSE(FileExists(logPath(1)));
+    EXPECT_TRUE(FileExists(logPath(2)));
+    EXPECT_TRUE(FileExists(logPath(3)));
+
+    // No amount of deleting frees this much space
+    EXPECT_EQ("", frc3512::TelemetryLogger::MakeLogPath(m_directory, 1000,
+                                                        3000, UINT64_MAX / 2));
+    EXPECT_FALSE(FileExists(logPath(2)));
+    EXPECT_FALSE(FileExists(logPath(3)));
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <units/angle.h>
+#include <units/length.h>
+#include <units/time.h>
+
+#include "TrajectoryBuilder.hpp"
+#include "controllers/MecanumVelocityController.hpp"
+#include "trajectory/TrajectoryCache.hpp"
+
+namespace {
+
+// Strafes right while turning left, like the autonomous paths
+PathDescription MakeStrafePath() {
+    return PathDescription::Parse(wpi::json::parse(R"({
+        "maxVelocity": 1.5,
+        "maxAcceleration": 1.5,
+        "waypoints": [
+            {"x": 0.0, "y": 0.0, "direction": -90.0},
+            {"x": 0.0, "y": -1.0, "direction": -90.0, "heading": 45.0}
+        ]
+    })"));
+}
+
+}  // namespace
+
+TEST(TrajectoryGeneratorTest, BuildsTrajectoryThroughWaypoints) {
+    auto samples = BuildTrajectory(MakeStrafePath(), 20_ms);
+    ASSERT_GT(samples.size(), 2u);
+
+    // Starts and ends at rest on the waypoints
+    const auto& first = samples.front();
+    EXPECT_NEAR(0.0, first.x, 1e-6);
+    EXPECT_NEAR(0.0, first.y, 1e-6);
+    EXPECT_NEAR(0.0, first.heading, 1e-6);
+    EXPECT_NEAR(0.0, first.vy, 1e-6);
+    EXPECT_NEAR(0.0, first.omega, 1e-6);
+
+    const auto& last = samples.back();
+    EXPECT_NEAR(0.0, last.x, 1e-3);
+    EXPECT_NEAR(-1.0, last.y, 1e-3);
+    EXPECT_NEAR(units::radian_t{45_deg}.to<double>(), last.heading, 1e-6);
+    EXPECT_NEAR(0.0, last.vy, 1e-3);
+    EXPECT_NEAR(0.0, last.omega, 1e-6);
+
+    // Halfway through, it's strafing right and turning left
+    const auto& middle = samples[samples.size() / 2];
+    EXPECT_LT(middle.vy, 0.0f);
+    EXPECT_GT(middle.omega, 0.0f);
+
+    EXPECT_LE(GetMaxWheelSpeed(samples).to<double>(),
+              MecanumVelocityController::kMaxSpeed.to<double>());
+}
+
+TEST(TrajectoryGeneratorTest, CacheMapsWrittenTrajectories) {
+    std::vector<NamedTrajectory> trajectories{
+        {"Strafe", BuildTrajectory(MakeStrafePath(), 20_ms)},
+        {"Short", std::vector<frc3512::TrajectorySample>(3)}};
+    trajectories[1].samples[2].x = 2.0f;
+
+    const char* path = "trajectory-test.bin";
+    WriteTrajectoryFile(path, trajectories, 20_ms);
+
+    frc3512::TrajectoryCache cache;
+    ASSERT_TRUE(cache.Load(path));
+    std::remove(path);
+    EXPECT_EQ(2u, cache.Size());
+    EXPECT_FALSE(cache.Get("Missing"));
+
+    auto strafe = cache.Get("Strafe");
+    ASSERT_TRUE(strafe);
+    ASSERT_EQ(trajectories[0].samples.size(), strafe->Size());
+    EXPECT_EQ(trajectories[0].samples[5].y, strafe->Sample(100_ms).y);
+    EXPECT_EQ(trajectories[0].samples.back().y, strafe->Sample(1000_s).y);
+
+    // Lookups round to the nearest sample and clamp to the ends
+    auto shortTrajectory = cache.Get("Short");
+    ASSERT_TRUE(shortTrajectory);
+    EXPECT_DOUBLE_EQ(0.04, shortTrajectory->GetTotalTime().to<double>());
+    EXPECT_EQ(0.0f, shortTrajectory->Sample(-1_s).x);
+    EXPECT_EQ(2.0f, shortTrajectory->Sample(35_ms).x);
+    EXPECT_EQ(2.0f, shortTrajectory->Sample(1_s).x);
+}
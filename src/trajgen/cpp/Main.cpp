@@ -0,0 +1,101 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Generates trajectories from the autonomous path files and writes them to
+// one file that TrajectoryCache memory-maps on the robot.
+//
+// Usage: trajectoryGenerator <output file> <path file>...
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <frc/TimedRobot.h>
+#include <units/time.h>
+#include <wpi/json.h>
+
+#include "TrajectoryBuilder.hpp"
+#include "controllers/MecanumVelocityController.hpp"
+
+namespace {
+
+// Samples are spaced by the robot loop's period, so following a trajectory
+// reads the next sample each cycle
+constexpr units::second_t kPeriod = frc::TimedRobot::kDefaultPeriod;
+
+/**
+ * Returns a path file's name without its directory or extension.
+ */
+std::string GetTrajectoryName(const std::string& path) {
+    auto start = path.find_last_of("/\\");
+    start = start == std::string::npos ? 0 : start + 1;
+    auto end = path.rfind('.');
+    if (end == std::string::npos || end < start) {
+        end = path.size();
+    }
+    return path.substr(start, end - start);
+}
+
+NamedTrajectory GenerateFromFile(const std::string& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error{fmt::format("couldn't open {}", path)};
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    auto description = PathDescription::Parse(wpi::json::parse(contents.str()));
+    auto samples = BuildTrajectory(description, kPeriod);
+
+    // The spline is limited to the wheels' maximum speed, but turning while
+    // translating can need more
+    auto maxWheelSpeed = GetMaxWheelSpeed(samples);
+    if (maxWheelSpeed > MecanumVelocityController::kMaxSpeed) {
+        throw std::runtime_error{fmt::format(
+            "needs {:.2f} m/s on a wheel, but the limit is {:.2f} m/s; lower "
+            "maxVelocity or turn over a longer distance",
+            maxWheelSpeed.to<double>(),
+            MecanumVelocityController::kMaxSpeed.to<double>())};
+    }
+
+    return NamedTrajectory{GetTrajectoryName(path), std::move(samples)};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fmt::print(stderr, "usage: {} <output file> <path file>...\n",
+                   argv[0]);
+        return 1;
+    }
+
+    std::vector<NamedTrajectory> trajectories;
+    for (int i = 2; i < argc; ++i) {
+        try {
+            trajectories.emplace_back(GenerateFromFile(argv[i]));
+        } catch (const std::exception& e) {
+            fmt::print(stderr, "error: {}: {}\n", argv[i], e.what());
+            return 1;
+        }
+
+        const auto& samples = trajectories.back().samples;
+        fmt::print("{}: {:.2f} s, {} samples\n", trajectories.back().name,
+                   (kPeriod * static_cast<double>(samples.size() - 1))
+                       .to<double>(),
+                   samples.size());
+    }
+
+    try {
+        WriteTrajectoryFile(argv[1], trajectories, kPeriod);
+    } catch (const std::runtime_error& e) {
+        fmt::print(stderr, "error: {}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,231 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "TrajectoryBuilder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+#include <fmt/core.h>
+#include <frc/kinematics/ChassisSpeeds.h>
+#include <frc/kinematics/MecanumDriveKinematics.h>
+#include <frc/trajectory/TrajectoryConfig.h>
+#include <frc/trajectory/TrajectoryGenerator.h>
+#include <frc/trajectory/constraint/MecanumDriveKinematicsConstraint.h>
+#include <units/length.h>
+#include <units/math.h>
+
+#include "MecanumPoseEstimator.hpp"
+#include "controllers/MecanumVelocityController.hpp"
+
+namespace {
+
+constexpr auto kWheelBase = MecanumPoseEstimator::kWheelBase;
+constexpr auto kTrackWidth = MecanumPoseEstimator::kTrackWidth;
+
+// Same wheel positions as MecanumPoseEstimator's
+const frc::MecanumDriveKinematics kKinematics{
+    {kWheelBase / 2, kTrackWidth / 2},
+    {kWheelBase / 2, -kTrackWidth / 2},
+    {-kWheelBase / 2, kTrackWidth / 2},
+    {-kWheelBase / 2, -kTrackWidth / 2}};
+
+/**
+ * Returns the index of each waypoint's nearest sample.
+ *
+ * Each waypoint after the first is searched for after the previous one's
+ * sample, so paths that cross themselves still map waypoints in order.
+ */
+std::vector<size_t> FindWaypointSamples(
+    const PathDescription& path,
+    const std::vector<frc3512::TrajectorySample>& samples) {
+    std::vector<size_t> indices{0};
+
+    for (size_t waypoint = 1; waypoint + 1 < path.waypoints.size();
+         ++waypoint) {
+        auto position = path.waypoints[waypoint].pose.Translation();
+
+        size_t nearest = indices.back();
+        auto nearestDistance = units::meter_t{INFINITY};
+        for (size_t i = indices.back(); i < samples.size(); ++i) {
+            frc::Translation2d sample{units::meter_t{samples[i].x},
+                                      units::meter_t{samples[i].y}};
+            auto distance = sample.Distance(position);
+            if (distance < nearestDistance) {
+                nearest = i;
+                nearestDistance = distance;
+            }
+        }
+        indices.emplace_back(nearest);
+    }
+
+    indices.emplace_back(samples.size() - 1);
+    return indices;
+}
+
+}  // namespace
+
+PathDescription PathDescription::Parse(const wpi::json& json) {
+    PathDescription path;
+    path.maxVelocity =
+        units::meters_per_second_t{json.at("maxVelocity").get<double>()};
+    path.maxAcceleration = units::meters_per_second_squared_t{
+        json.at("maxAcceleration").get<double>()};
+    if (path.maxVelocity <= 0_mps || path.maxAcceleration <= 0_mps_sq) {
+        throw std::runtime_error{
+            "maxVelocity and maxAcceleration must be positive"};
+    }
+
+    units::degree_t heading = 0_deg;
+    for (const auto& waypoint : json.at("waypoints")) {
+        if (waypoint.count("heading")) {
+            heading = units::degree_t{waypoint.at("heading").get<double>()};
+        }
+        path.waypoints.emplace_back(PathWaypoint{
+            frc::Pose2d{
+                units::meter_t{waypoint.at("x").get<double>()},
+                units::meter_t{waypoint.at("y").get<double>()},
+                units::degree_t{waypoint.at("direction").get<double>()}},
+            heading});
+    }
+    if (path.waypoints.size() < 2) {
+        throw std::runtime_error{"a path needs at least two waypoints"};
+    }
+
+    return path;
+}
+
+std::vector<frc3512::TrajectorySample> BuildTrajectory(
+    const PathDescription& path, units::second_t period) {
+    frc::TrajectoryConfig config{path.maxVelocity, path.maxAcceleration};
+    config.AddConstraint(frc::MecanumDriveKinematicsConstraint{
+        kKinematics, MecanumVelocityController::kMaxSpeed});
+
+    std::vector<frc::Pose2d> poses;
+    for (const auto& waypoint : path.waypoints) {
+        poses.emplace_back(waypoint.pose);
+    }
+    auto trajectory =
+        frc::TrajectoryGenerator::GenerateTrajectory(poses, config);
+    auto totalTime = trajectory.TotalTime();
+
+    // The last sample is at the end of the trajectory even if the total time
+    // isn't a multiple of the period
+    auto sampleCount =
+        static_cast<size_t>(std::ceil((totalTime / period).to<double>())) + 1;
+    std::vector<frc3512::TrajectorySample> samples(sampleCount);
+    std::vector<units::second_t> times(sampleCount);
+    for (size_t i = 0; i < sampleCount; ++i) {
+        times[i] = units::math::min(period * static_cast<double>(i), totalTime);
+        auto state = trajectory.Sample(times[i]);
+        auto direction = state.pose.Rotation();
+
+        auto& sample = samples[i];
+        sample.x = static_cast<float>(state.pose.X().to<double>());
+        sample.y = static_cast<float>(state.pose.Y().to<double>());
+        sample.vx =
+            static_cast<float>((state.velocity * direction.Cos()).to<double>());
+        sample.vy =
+            static_cast<float>((state.velocity * direction.Sin()).to<double>());
+    }
+
+    // Turn from each waypoint's heading to the next along a cubic that starts
+    // and ends at rest, so the angular velocity is continuous
+    auto waypointSamples = FindWaypointSamples(path, samples);
+    samples[0].heading =
+        static_cast<float>(path.waypoints[0].heading.to<double>());
+    for (size_t waypoint = 0; waypoint + 1 < path.waypoints.size();
+         ++waypoint) {
+        size_t start = waypointSamples[waypoint];
+        size_t end = waypointSamples[waypoint + 1];
+        units::radian_t startHeading = path.waypoints[waypoint].heading;
+        units::radian_t turn =
+            path.waypoints[waypoint + 1].heading - startHeading;
+        auto duration = times[end] - times[start];
+
+        for (size_t i = start + 1; i <= end; ++i) {
+            double s = ((times[i] - times[start]) / duration).to<double>();
+            samples[i].heading = static_cast<float>(
+                (startHeading + turn * (3.0 * s * s - 2.0 * s * s * s))
+                    .to<double>());
+            samples[i].omega = static_cast<float>(
+                (turn * 6.0 * s * (1.0 - s) / duration).to<double>());
+        }
+    }
+
+    return samples;
+}
+
+units::meters_per_second_t GetMaxWheelSpeed(
+    const std::vector<frc3512::TrajectorySample>& samples) {
+    auto maxSpeed = 0_mps;
+
+    for (const auto& sample : samples) {
+        auto speeds = frc::ChassisSpeeds::FromFieldRelativeSpeeds(
+            units::meters_per_second_t{sample.vx},
+            units::meters_per_second_t{sample.vy},
+            units::radians_per_second_t{sample.omega},
+            frc::Rotation2d{units::radian_t{sample.heading}});
+        auto wheelSpeeds = kKinematics.ToWheelSpeeds(speeds);
+        for (auto speed : {wheelSpeeds.frontLeft, wheelSpeeds.frontRight,
+                           wheelSpeeds.rearLeft, wheelSpeeds.rearRight}) {
+            maxSpeed = units::math::max(maxSpeed, units::math::abs(speed));
+        }
+    }
+
+    return maxSpeed;
+}
+
+void WriteTrajectoryFile(const std::string& path,
+                         const std::vector<NamedTrajectory>& trajectories,
+                         units::second_t period) {
+    frc3512::TrajectoryFileHeader header;
+    header.trajectoryCount = static_cast<uint32_t>(trajectories.size());
+
+    std::vector<frc3512::TrajectoryEntry> entries;
+    uint32_t firstSample = 0;
+    for (const auto& trajectory : trajectories) {
+        constexpr size_t kMaxNameLength =
+            frc3512::TrajectoryEntry::kMaxNameLength;
+        if (trajectory.name.size() > kMaxNameLength) {
+            throw std::runtime_error{
+                fmt::format("trajectory name {} is longer than {} characters",
+                            trajectory.name, kMaxNameLength)};
+        }
+
+        frc3512::TrajectoryEntry entry;
+        entry.name.fill('\0');
+        std::copy(trajectory.name.begin(), trajectory.name.end(),
+                  entry.name.begin());
+        entry.firstSample = firstSample;
+        entry.sampleCount = static_cast<uint32_t>(trajectory.samples.size());
+        entry.period = static_cast<uint32_t>(
+            std::round(units::microsecond_t{period}.to<double>()));
+        entries.emplace_back(entry);
+
+        firstSample += entry.sampleCount;
+    }
+
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file{
+        std::fopen(path.c_str(), "wb"), &std::fclose};
+    if (file == nullptr) {
+        throw std::runtime_error{fmt::format("couldn't open {}", path)};
+    }
+
+    bool written =
+        std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+        std::fwrite(entries.data(), sizeof(frc3512::TrajectoryEntry),
+                    entries.size(), file.get()) == entries.size();
+    for (const auto& trajectory : trajectories) {
+        written = written &&
+                  std::fwrite(trajectory.samples.data(),
+                              sizeof(frc3512::TrajectorySample),
+                              trajectory.samples.size(),
+                              file.get()) == trajectory.samples.size();
+    }
+    if (!written || std::fclose(file.release()) != 0) {
+        throw std::runtime_error{fmt::format("couldn't write {}", path)};
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <frc/geometry/Pose2d.h>
+#include <units/acceleration.h>
+#include <units/angle.h>
+#include <units/time.h>
+#include <units/velocity.h>
+#include <wpi/json.h>
+
+#include "trajectory/TrajectoryFormat.hpp"
+
+/**
+ * A waypoint of a path file.
+ */
+struct PathWaypoint {
+    // Position, and the direction of travel through the position
+    frc::Pose2d pose;
+
+    // The robot's heading at the position. Mecanum drives can face any
+    // direction while traveling, so this is separate from the direction of
+    // travel.
+    units::radian_t heading;
+};
+
+/**
+ * An autonomous path described by a JSON file in src/main/deploy/paths.
+ *
+ * The file is an object with these keys:
+ *
+ * - "maxVelocity": Maximum speed across the field in m/s.
+ * - "maxAcceleration": Maximum acceleration in m/s².
+ * - "waypoints": Array of at least two objects with "x" and "y" in meters,
+ *   "direction" in degrees, and an optional "heading" in degrees that
+ *   defaults to the previous waypoint's, or zero for the first one.
+ *
+ * Coordinates are in the field frame MecanumPoseEstimator uses: X is forward
+ * and Y is left of the robot's starting pose, and angles are counterclockwise
+ * positive.
+ */
+struct PathDescription {
+    units::meters_per_second_t maxVelocity;
+    units::meters_per_second_squared_t maxAcceleration;
+    std::vector<PathWaypoint> waypoints;
+
+    /**
+     * Parses a path file's contents.
+     *
+     * @param json Path file contents.
+     * @throws wpi::json::exception if a key is missing or has the wrong type.
+     * @throws std::runtime_error if there are fewer than two waypoints.
+     */
+    static PathDescription Parse(const wpi::json& json);
+};
+
+/**
+ * A generated trajectory and the name it's stored under.
+ */
+struct NamedTrajectory {
+    std::string name;
+    std::vector<frc3512::TrajectorySample> samples;
+};
+
+/**
+ * Generates a time-parameterized trajectory through a path's waypoints and
+ * samples it at a fixed period.
+ *
+ * The translation follows a quintic spline through the waypoints, limited by
+ * the path's maximum velocity and acceleration and by the wheels' maximum
+ * speed. The heading moves from each waypoint's heading to the next with zero
+ * angular velocity at every waypoint.
+ *
+ * @param path   The path.
+ * @param period Time between samples.
+ * @return Samples from the start of the trajectory to the end inclusive.
+ */
+std::vector<frc3512::TrajectorySample> BuildTrajectory(
+    const PathDescription& path, units::second_t period);
+
+/**
+ * Returns the highest wheel speed needed to follow a trajectory, including
+ * the rotation.
+ *
+ * @param samples Trajectory samples.
+ */
+units::meters_per_second_t GetMaxWheelSpeed(
+    const std::vector<frc3512::TrajectorySample>& samples);
+
+/**
+ * Writes trajectories to a file in the format TrajectoryCache loads.
+ *
+ * @param path         Path of the file.
+ * @param trajectories Trajectories to write.
+ * @param period       Time between the trajectories' samples.
+ * @throws std::runtime_error if a name is too long or the file couldn't be
+ *         written.
+ */
+void WriteTrajectoryFile(const std::string& path,
+                         const std::vector<NamedTrajectory>& trajectories,
+                         units::second_t period);